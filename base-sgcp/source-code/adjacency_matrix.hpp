@@ -0,0 +1,96 @@
+#ifndef _ADJACENCY_MATRIX_HPP
+#define _ADJACENCY_MATRIX_HPP
+
+#include "bitset.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+namespace sgcp {
+    // Symmetric adjacency matrix stored as one packed bitset row per vertex. Every
+    // row starts on a cache line, so row-wise operations are plain word loops.
+    // Vertices are indexed by their (current) id.
+    class AdjacencyMatrix {
+        uint32_t n;
+        uint32_t stride;
+        Bitset::Storage rows;
+
+        Bitset::Word* row(uint32_t i) { assert(i < n); return rows.data() + static_cast<std::size_t>(i) * stride; }
+
+    public:
+        AdjacencyMatrix() : n{0u}, stride{0u} {}
+        explicit AdjacencyMatrix(uint32_t n) : n{n}, stride{Bitset::words_for(n)}, rows(static_cast<std::size_t>(n) * stride, 0u) {}
+
+        uint32_t size() const { return n; }
+
+        // Number of words in each row. Matches Bitset::n_words() of a bitset of size().
+        uint32_t n_words() const { return stride; }
+
+        const Bitset::Word* row(uint32_t i) const { assert(i < n); return rows.data() + static_cast<std::size_t>(i) * stride; }
+
+        void add_edge(uint32_t i, uint32_t j) {
+            row(i)[j / Bitset::word_bits] |= Bitset::Word{1u} << (j % Bitset::word_bits);
+            row(j)[i / Bitset::word_bits] |= Bitset::Word{1u} << (i % Bitset::word_bits);
+        }
+
+        bool connected(uint32_t i, uint32_t j) const {
+            assert(j < n);
+            return (row(i)[j / Bitset::word_bits] >> (j % Bitset::word_bits)) & 1u;
+        }
+
+        uint32_t degree(uint32_t i) const {
+            const auto* r = row(i);
+            uint32_t d = 0u;
+            for(auto w = 0u; w < stride; ++w) { d += __builtin_popcountll(r[w]); }
+            return d;
+        }
+
+        // Tells whether the closed neighbourhood of i is contained in the one of j.
+        bool closed_neighbourhood_included(uint32_t i, uint32_t j) const {
+            if(i != j && !connected(i, j)) { return false; }
+
+            // Bit j is set in row i, but j belongs to its own closed neighbourhood.
+            const auto* ri = row(i);
+            const auto* rj = row(j);
+            auto jw = j / Bitset::word_bits;
+            auto acc = ri[jw] & ~rj[jw] & ~(Bitset::Word{1u} << (j % Bitset::word_bits));
+            for(auto w = 0u; w < jw; ++w) { acc |= ri[w] & ~rj[w]; }
+            for(auto w = jw + 1u; w < stride; ++w) { acc |= ri[w] & ~rj[w]; }
+            return acc == 0u;
+        }
+
+        // Same as above, only counting the vertices in within (i and j need not be in it).
+        bool closed_neighbourhood_included(uint32_t i, uint32_t j, const Bitset& within) const {
+            assert(within.size() == n);
+            if(i != j && !connected(i, j)) { return false; }
+
+            const auto* ri = row(i);
+            const auto* rj = row(j);
+            const auto* rw = within.data();
+            auto jw = j / Bitset::word_bits;
+            auto acc = ri[jw] & ~rj[jw] & rw[jw] & ~(Bitset::Word{1u} << (j % Bitset::word_bits));
+            for(auto w = 0u; w < jw; ++w) { acc |= ri[w] & ~rj[w] & rw[w]; }
+            for(auto w = jw + 1u; w < stride; ++w) { acc |= ri[w] & ~rj[w] & rw[w]; }
+            return acc == 0u;
+        }
+
+        // Tells whether all the neighbours of i in within are also in s.
+        bool neighbourhood_included(uint32_t i, const Bitset& s, const Bitset& within) const {
+            assert(s.size() == n && within.size() == n);
+            const auto* ri = row(i);
+            const auto* rs = s.data();
+            const auto* rw = within.data();
+            Bitset::Word acc = 0u;
+            for(auto w = 0u; w < stride; ++w) { acc |= ri[w] & ~rs[w] & rw[w]; }
+            return acc == 0u;
+        }
+
+        // Tells whether vertex i is adjacent to any vertex of s.
+        bool adjacent_to_any(uint32_t i, const Bitset& s) const {
+            assert(s.size() == n);
+            return Bitset::intersects(row(i), s.data(), stride);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef _BITSET_HPP
+#define _BITSET_HPP
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sgcp {
+    // Fixed-size bitset whose storage is aligned to a cache line and padded to a
+    // whole number of cache lines. Padding bits are always zero, so word-wise loops
+    // (which the compiler vectorises) can run over all the words without masking.
+    class Bitset {
+    public:
+        using Word = uint64_t;
+        using Storage = std::vector<Word, boost::alignment::aligned_allocator<Word, 64u>>;
+
+        static constexpr uint32_t word_bits = 64u;
+        static constexpr uint32_t line_words = 8u;
+
+        // Number of words needed to store n_bits bits, rounded up to whole cache lines.
+        static uint32_t words_for(uint32_t n_bits) {
+            return ((n_bits + word_bits * line_words - 1u) / (word_bits * line_words)) * line_words;
+        }
+
+        // Tells whether two word arrays of the same length have a common bit set.
+        static bool intersects(const Word* a, const Word* b, uint32_t n_words) {
+            Word acc = 0u;
+            for(auto w = 0u; w < n_words; ++w) { acc |= a[w] & b[w]; }
+            return acc != 0u;
+        }
+
+    private:
+        uint32_t n_bits;
+        Storage words;
+
+    public:
+        Bitset() : n_bits{0u} {}
+        explicit Bitset(uint32_t n_bits) : n_bits{n_bits}, words(words_for(n_bits), 0u) {}
+
+        uint32_t size() const { return n_bits; }
+        uint32_t n_words() const { return words.size(); }
+        const Word* data() const { return words.data(); }
+
+        bool test(uint32_t i) const { assert(i < n_bits); return (words[i / word_bits] >> (i % word_bits)) & 1u; }
+        void set(uint32_t i) { assert(i < n_bits); words[i / word_bits] |= Word{1u} << (i % word_bits); }
+        void reset(uint32_t i) { assert(i < n_bits); words[i / word_bits] &= ~(Word{1u} << (i % word_bits)); }
+        void reset() { std::fill(words.begin(), words.end(), 0u); }
+
+        bool any() const {
+            Word acc = 0u;
+            for(auto w : words) { acc |= w; }
+            return acc != 0u;
+        }
+
+        uint32_t count() const {
+            uint32_t c = 0u;
+            for(auto w : words) { c += __builtin_popcountll(w); }
+            return c;
+        }
+
+        bool intersects(const Bitset& other) const {
+            assert(n_bits == other.n_bits);
+            return intersects(data(), other.data(), n_words());
+        }
+
+        // Tells whether all the bits set in this bitset are also set in other.
+        bool is_subset_of(const Bitset& other) const {
+            assert(n_bits == other.n_bits);
+            Word acc = 0u;
+            for(auto w = 0u; w < words.size(); ++w) { acc |= words[w] & ~other.words[w]; }
+            return acc == 0u;
+        }
+
+        // Calls f(i) for each bit i which is set, in increasing order.
+        template<typename F>
+        void for_each(F&& f) const {
+            for(auto w = 0u; w < words.size(); ++w) {
+                for(Word word = words[w]; word != 0u; word &= word - 1u) {
+                    f(w * word_bits + static_cast<uint32_t>(__builtin_ctzll(word)));
+                }
+            }
+        }
+
+        // Combines all the words into a hash value (padding words are zero, so they
+        // do not change the result across bitsets of the same size).
+        std::size_t hash() const {
+            std::size_t h = n_bits;
+            for(auto w : words) { h ^= w + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); }
+            return h;
+        }
+
+        friend bool operator==(const Bitset& lhs, const Bitset& rhs) { return lhs.n_bits == rhs.n_bits && lhs.words == rhs.words; }
+        friend bool operator!=(const Bitset& lhs, const Bitset& rhs) { return !(lhs == rhs); }
+
+        // Word-wise lexicographic order, only meant for use in sorted containers.
+        friend bool operator<(const Bitset& lhs, const Bitset& rhs) {
+            if(lhs.n_bits != rhs.n_bits) { return lhs.n_bits < rhs.n_bits; }
+            return std::lexicographical_compare(lhs.words.begin(), lhs.words.end(), rhs.words.begin(), rhs.words.end());
+        }
+    };
+}
+
+#endif
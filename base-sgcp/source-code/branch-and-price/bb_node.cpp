@@ -7,14 +7,13 @@
 #include <cmath>
 #include <chrono>
 #include <iostream>
+#include <numeric>
 #include <stdexcept>
 
 namespace sgcp {
     BBNode::BBNode( std::shared_ptr<const Graph> o,
                     std::shared_ptr<const BranchingRule> br,
                     ColumnPool& c,
-                    std::vector<uint32_t> forbidden_columns,
-                    std::vector<uint32_t> initial_solution_ids,
                     uint32_t node_id,
                     uint32_t depth,
                     boost::optional<float> bound_from_father,
@@ -23,26 +22,22 @@ namespace sgcp {
                     br{br},
                     g{nullptr},
                     c{c},
-                    forbidden_columns{forbidden_columns},
-                    initial_solution_ids{initial_solution_ids},
+                    n_checked_columns{0u},
                     node_id{node_id},
                     depth{depth},
                     bound_from_father{bound_from_father},
-                    stats{stats}
-    {
-        for(auto cid = 0u; cid < this->c.get().size(); cid++) {
-            if(std::find(forbidden_columns.begin(), forbidden_columns.end(), cid) != forbidden_columns.end()) { continue; }
-            if(!br->is_compatible(this->c.get().at(cid))) { this->forbidden_columns.push_back(cid); }
-            else { this->whitelisted_columns.push_back(cid); }
-        }
-    }
+                    stats{stats} {}
+
+    uint32_t BBNode::check_new_columns(const GraphOverlay& overlay) {
+        auto n_columns = c.get().size();
 
-    void BBNode::check_new_columns() {
-        for(auto cid = 0u; cid < c.get().size(); cid++) {
-            if(std::find(forbidden_columns.begin(), forbidden_columns.end(), cid) != forbidden_columns.end()) { continue; }
-            if(std::find(whitelisted_columns.begin(), whitelisted_columns.end(), cid) != whitelisted_columns.end()) { continue; }
-            if(!g->is_compatible_as_stable_set(c.get().at(cid).get_set())) { forbidden_columns.push_back(cid); }
+        for(auto cid = n_checked_columns; cid < n_columns; cid++) {
+            if(!overlay.is_compatible(c.get().at(cid))) { forbidden_columns.insert(cid); }
         }
+
+        n_checked_columns = n_columns;
+
+        return n_columns;
     }
 
     boost::optional<BBSolution> BBNode::solve(float ub, MpSolver& lp_solver, MpSolver& mip_solver) {
@@ -51,25 +46,37 @@ namespace sgcp {
 
         // Build the local graph
         assert(g == nullptr);
-        g = br->apply();
+        auto overlay = br->overlay();
+        g = overlay.materialise();
 
         std::vector<StableSet> new_columns;
 
         DEBUG_ONLY(std::cout << Colour::Magenta << "Node id: " << node_id << ", depth: " << depth << Colour::Default << std::endl << std::endl;)
 
-        check_new_columns();
-
         stats.get().num_pri_cols.push_back(0u);
 
         bool first_run = true;
         float last_pricing_violation = 0;
 
+        // Best Farley bound found at this node, valid for the whole node. The duals giving
+        // it are the stability centre for dual smoothing.
+        float node_lb = 0;
+        boost::optional<std::vector<float>> stab_centre;
+
+        // The pricing solver keeps its data structures across column generation iterations.
+        auto mwss_solver = MwssSolver{*o, *g};
+
         while(true) {
             auto lp_start_time = high_resolution_clock::now();
 
             boost::optional<MpSolution> mp_solution;
-            if(first_run) { mp_solution = lp_solver.solve_with_forbidden_check(forbidden_columns); }
-            else { mp_solution = lp_solver.solve_without_forbidden_check(forbidden_columns); }
+            // When the tree is explored by more than one thread, the other nodes add columns to
+            // the pool while this one is solved: they must be checked before each solve, and
+            // those which arrive in the meantime are left out of the LP until the next one.
+            if(first_run || g->params.bb_threads > 1u) {
+                auto n_checked = check_new_columns(overlay);
+                mp_solution = lp_solver.solve_with_forbidden_check(forbidden_columns, n_checked);
+            } else { mp_solution = lp_solver.solve_without_forbidden_check(forbidden_columns); }
 
             auto lp_end_time = high_resolution_clock::now();
             auto lp_time_s = duration_cast<duration<float>>(lp_end_time - lp_start_time).count();
@@ -79,6 +86,7 @@ namespace sgcp {
 
             stats.get().tot_computing_time += lp_time_s;
             stats.get().tot_lp_time += lp_time_s;
+            stats.get().n_cg_iterations++;
 
             if(node_id == 0u) {
                 stats.get().root_node_time = stats.get().tot_computing_time;
@@ -97,39 +105,76 @@ namespace sgcp {
 
             first_run = false;
 
-            auto mwss_solver = MwssSolver{*o, *g};
+            StableSetCollection priced_columns;
+
+            if(!stab_centre) { stab_centre = mp_solution->duals; }
 
-            auto pricing_start_time = high_resolution_clock::now();
-            auto sp_columns = mwss_solver.solve(*mp_solution);
-            auto pricing_end_time = high_resolution_clock::now();
-            auto pricing_time_s = duration_cast<duration<float>>(pricing_end_time - pricing_start_time).count();
+            // With Wentges smoothing, the pricing uses a convex combination of the stability
+            // centre and the LP duals. If it finds no column improving for the LP duals (a
+            // mis-pricing) it is repeated with a smaller weight on the centre, until it uses
+            // the LP duals alone: so column generation still ends with a proof of optimality.
+            for(auto n_mispricings = 0u; priced_columns.empty(); ++n_mispricings) {
+                auto alpha = 0.0f;
+                if(g->params.stabilisation_method == "wentges") {
+                    alpha = std::max(0.0f, 1.0f - (n_mispricings + 1u) * (1.0f - g->params.stabilisation_alpha));
+                }
 
-            stats.get().tot_computing_time += pricing_time_s;
-            stats.get().tot_pricing_time += pricing_time_s;
+                auto sep_solution = *mp_solution;
+                for(auto k = 0u; k < sep_solution.duals.size(); ++k) {
+                    sep_solution.duals[k] = alpha * (*stab_centre)[k] + (1.0f - alpha) * mp_solution->duals[k];
+                }
 
-            bool new_valid_columns = false;
+                auto pricing_start_time = high_resolution_clock::now();
+                auto sp_solution = mwss_solver.solve(sep_solution, min_reduced_cost + eps);
+                const auto& sp_columns = sp_solution.columns;
+                auto pricing_end_time = high_resolution_clock::now();
+                auto pricing_time_s = duration_cast<duration<float>>(pricing_end_time - pricing_start_time).count();
+
+                stats.get().tot_computing_time += pricing_time_s;
+                stats.get().tot_pricing_time += pricing_time_s;
+
+                // Farley bound: dividing the (non-negative) duals by an upper bound on the reduced
+                // cost of any column makes them dual feasible. The pricing gives one at every round
+                // (exact or not), so the centre moves to the pricing duals whenever they give a
+                // better bound, even when heuristic or early-exit pricing is on.
+                auto max_reduced_cost = std::max(min_reduced_cost + eps, sp_solution.upper_bound);
+                auto farley_bound = std::accumulate(sep_solution.duals.begin(), sep_solution.duals.end(), 0.0f) / max_reduced_cost;
+
+                if(farley_bound > node_lb) {
+                    node_lb = farley_bound;
+                    stab_centre = sep_solution.duals;
+                }
 
-            for(const auto& col : sp_columns) {
-                last_pricing_violation = col.reduced_cost(mp_solution->duals);
+                // When the pricing is solved exactly on the LP duals, the first column is the
+                // optimal one, and its reduced cost is needed to compute the Lagrangian bound.
+                // A heuristic, early-exit or smoothed pricing round gives no bound.
+                if(!sp_solution.optimal || alpha > 0) { last_pricing_violation = 0; }
+                else if(!sp_columns.empty()) { last_pricing_violation = sp_columns.front().reduced_cost(mp_solution->duals); }
 
-                if(last_pricing_violation > min_reduced_cost + eps) {
-                    DEBUG_ONLY(std::cout << "\tNew column generated: " << Colour::Green << col << Colour::Default << " (reduced cost: " << colour_magenta(col.reduced_cost(mp_solution->duals)) << ")" << std::endl;)
+                for(const auto& col : sp_columns) {
+                    if(col.reduced_cost(mp_solution->duals) > min_reduced_cost + eps) {
+                        DEBUG_ONLY(std::cout << "\tNew column generated: " << Colour::Green << col << Colour::Default << " (reduced cost: " << colour_magenta(col.reduced_cost(mp_solution->duals)) << ")" << std::endl;)
 
-                    assert(std::none_of(c.get().begin(), c.get().end(), [&] (const auto& lcol) { return lcol == col; }));
+                        // Another thread might have just added the same column to the pool.
+                        __attribute__((unused)) auto id_added = c.get().insert(col);
+                        assert(id_added.second || g->params.bb_threads > 1u);
 
-                    new_valid_columns = true;
-                    new_columns.push_back(col);
-                    c.get().push_back(col);
-                    lp_solver.add_column(col);
-                    mip_solver.add_column(col);
-                    stats.get().num_pri_cols.back()++;
-                } else {
-                    DEBUG_ONLY(std::cout << "\tNew column discarded: " << Colour::Red << col << Colour::Default << " (reduced cost: " << colour_magenta(col.reduced_cost(mp_solution->duals)) << ")" << std::endl;)
+                        priced_columns.push_back(col);
+                        stats.get().num_pri_cols.back()++;
+                    } else {
+                        DEBUG_ONLY(std::cout << "\tNew column discarded: " << Colour::Red << col << Colour::Default << " (reduced cost: " << colour_magenta(col.reduced_cost(mp_solution->duals)) << ")" << std::endl;)
+                    }
+                    DEBUG_ONLY(std::cout << std::endl;)
                 }
-                DEBUG_ONLY(std::cout << std::endl;)
+
+                if(alpha == 0.0f) { break; }
+                if(priced_columns.empty()) { stats.get().n_mispricings++; }
             }
 
-            if(!new_valid_columns) {
+            // The LP and MIP solvers pick up the new columns from the pool when they are next used.
+            new_columns.insert(new_columns.end(), priced_columns.begin(), priced_columns.end());
+
+            if(priced_columns.empty()) {
                 // If the solution has the dummy column in its base columns, consider it as infeasible.
                 for(const auto& col_val : mp_solution->columns) {
                     if(col_val.first.dummy && col_val.second > eps) { return boost::none; }
@@ -137,16 +182,37 @@ namespace sgcp {
 
                 return get_bbsolution(mip_solver, *mp_solution, new_columns, ub);
             }
+
+            // Column generation can stop early if the bound shows that the node cannot improve
+            // on the incumbent, or that the rounded-up LP bound cannot go any further down.
+            // The node is then branched on (or pruned) using the current LP solution.
+            if(g->params.bb_early_node_termination && node_lb > eps) {
+                auto dummy_active = std::any_of(
+                    mp_solution->columns.begin(),
+                    mp_solution->columns.end(),
+                    [] (const auto& col_val) { return col_val.first.dummy && col_val.second > eps; }
+                );
+
+                auto rounded_lb = std::ceil(node_lb - eps);
+                auto pruned = rounded_lb > ub - eps;
+                auto converged = !dummy_active && rounded_lb > std::ceil(mp_solution->obj_value - eps) - eps;
+
+                if(pruned || converged) {
+                    DEBUG_ONLY(std::cout << colour_magenta("Column generation stopped early with bound ") << node_lb << std::endl << std::endl;)
+                    stats.get().n_early_terminations++;
+                    return get_bbsolution(mip_solver, *mp_solution, new_columns, ub, node_lb);
+                }
+            }
         }
 
         return boost::none;
     }
 
-    BBSolution BBNode::get_bbsolution(const MpSolver& mip_solver, const MpSolution& mp_solution, const std::vector<StableSet>& new_columns, float ub) const {
+    BBSolution BBNode::get_bbsolution(const MpSolver& mip_solver, const MpSolution& mp_solution, const std::vector<StableSet>& new_columns, float ub, boost::optional<float> node_lb) const {
         DEBUG_ONLY(using namespace Console;)
         using namespace std::chrono;
 
-        float lb = mp_solution.obj_value;
+        float lb = node_lb ? *node_lb : mp_solution.obj_value;
         ActiveColumnsWithCoeff integer_solution_columns{};
         ActiveColumnsWithCoeff lp_solution_columns = mp_solution.active_columns_by_id(c);
 
@@ -219,7 +285,7 @@ namespace sgcp {
                     ub - std::ceil(lb) > 0.5f // Otherwise we just found the optimal solution with MIP, no need for ALNS
                 ) {
                     // Try to improve on the MIP solution with ALNS
-                    ColumnPool initial_solution;
+                    StableSetCollection initial_solution;
                     for(const auto& cid_val : integer_solution_columns) {
                         initial_solution.push_back(c.get().at(cid_val.first));
                     }
@@ -227,32 +293,17 @@ namespace sgcp {
                     auto init_sol_gen = InitialSolutionsGenerator{*o, stats};
                     auto sol = init_sol_gen.generate_from_existing(initial_solution);
 
-                    if(sol.columns.size() < ub) {
+                    if(sol.feasible_solution_ids.size() < ub) {
                         integer_solution_columns = ActiveColumnsWithCoeff{};
 
                         for(auto id : sol.feasible_solution_ids) {
-                            boost::optional<uint32_t> id_in_column_pool = boost::none;
-
-                            const auto& s = sol.columns.at(id);
-
-                            for(auto cid = 0u; cid < c.get().size(); ++cid) {
-                                if(c.get().at(cid) == s) {
-                                    id_in_column_pool = cid;
-                                    break;
-                                }
-                            }
-
-                            if(id_in_column_pool) {
-                                integer_solution_columns[*id_in_column_pool] = 1.0;
-                            } else {
-                                c.get().push_back(s);
-                                integer_solution_columns[c.get().size() - 1] = 1.0;
-                            }
+                            auto cid = c.get().insert(sol.columns.at(id)).first;
+                            integer_solution_columns[cid] = 1.0;
                         }
 
-                        assert(integer_solution_columns.size() == sol.columns.size());
+                        assert(integer_solution_columns.size() == sol.feasible_solution_ids.size());
 
-                        ub = sol.columns.size();
+                        ub = sol.feasible_solution_ids.size();
                     }
                 }
             }
@@ -6,6 +6,7 @@
 #include "mp_solver.hpp"
 #include "branching_rules.hpp"
 #include "column_pool.hpp"
+#include "column_set.hpp"
 #include "bb_solution.hpp"
 
 #include <memory>
@@ -17,25 +18,32 @@
 #include <boost/optional.hpp>
 
 namespace sgcp {
+    // A node of the branch-and-bound tree. While a node is open, it only consists of
+    // the rule which generated it (which gives the whole path of decisions from the
+    // root, through its ancestors' rules) and the bound inherited from its father.
+    // The local graph and the set of forbidden columns are derived from the
+    // decisions when the node is solved.
     struct BBNode {
         // Original graph, before any branching rules modified it.
         std::shared_ptr<const Graph> o;
 
-        // Branching rule to be used to build the local graph. It is kept here in a
-        // shared pointer, rather than used immediately in the constructor, in order
-        // to build the local graph lazily, only when actually solving the node.
+        // Branching rule which generated the node. Together with its ancestors, it gives
+        // the decisions to apply to the original graph to build the local graph, which
+        // is done lazily, only when actually solving the node.
         std::shared_ptr<const BranchingRule> br;
 
-        // Local graph, as modified by the branching rules.
-        // It is kept in a shared pointer, so the graph of a certain node is kept alive
-        // by the branching rule generated by that node and can then be used in the
-        // children nodes to build their own local graphs.
+        // Local graph, as modified by the branching rules. It is only built when the
+        // node is solved, and released together with the node: children nodes build
+        // their own from the original graph.
         std::shared_ptr<const Graph> g;
 
         std::reference_wrapper<ColumnPool> c;
-        std::vector<uint32_t> forbidden_columns;
-        std::vector<uint32_t> whitelisted_columns;
-        std::vector<uint32_t> initial_solution_ids;
+
+        // Columns of the pool which are not compatible with the node's decisions,
+        // among the first n_checked_columns ones (the others have not been checked
+        // yet). Empty until the node is solved.
+        ColumnSet forbidden_columns;
+        uint32_t n_checked_columns;
 
         uint32_t node_id;
         uint32_t depth;
@@ -49,8 +57,6 @@ namespace sgcp {
         BBNode( std::shared_ptr<const Graph> o,
                 std::shared_ptr<const BranchingRule> br,
                 ColumnPool& c,
-                std::vector<uint32_t> forbidden_columns,
-                std::vector<uint32_t> initial_solution_ids,
                 uint32_t node_id,
                 uint32_t depth,
                 boost::optional<float> bound_from_father,
@@ -59,19 +65,19 @@ namespace sgcp {
         boost::optional<BBSolution> solve(float ub, MpSolver& lp_solver, MpSolver& mip_solver);
 
     private:
-        // Checks whether the new columns, added to the column pool by other
-        // BB nodes in the time between when this node was created and when
-        // it is explored, are to be forbidden. This check uses the BB node's
-        // graph and therefore is much more expensive than the check done in
-        // the constructor, which uses the branching rule. Anyways, only the
-        // columns that were not whitelisted or already forbidden are checked,
-        // so the number of checks should be quite limited.
-        void check_new_columns();
-
+        // Forbids the columns of the pool which are not compatible with the
+        // decisions leading to the node. The first call checks the whole pool;
+        // later calls only check the columns added to the pool in the meantime.
+        // Returns the number of columns in the pool when the check was made.
+        uint32_t check_new_columns(const GraphOverlay& overlay);
+
+        // Builds the node's solution. The node's lower bound is the LP value, unless column
+        // generation was stopped early, in which case it is the bound which stopped it.
         BBSolution get_bbsolution(  const MpSolver& mip_solver,
                                     const MpSolution& mp_solution,
                                     const std::vector<StableSet>& new_columns,
-                                    float ub) const;
+                                    float ub,
+                                    boost::optional<float> node_lb = boost::none) const;
     };
 }
 
@@ -4,6 +4,7 @@
 #include "../graph.hpp"
 #include "../stable_set.hpp"
 #include "column_pool.hpp"
+#include "column_set.hpp"
 #include "mp_solution.hpp"
 
 #include <cmath>
@@ -15,7 +16,7 @@ namespace sgcp {
         float lb;
         ActiveColumnsWithCoeff integer_solution_columns;
         ActiveColumnsWithCoeff lp_solution_columns;
-        std::vector<uint32_t> forbidden_columns;
+        ColumnSet forbidden_columns;
         std::shared_ptr<const Graph> g;
         bool timeout;
 
@@ -25,7 +26,7 @@ namespace sgcp {
                     float lb,
                     ActiveColumnsWithCoeff integer_solution_columns,
                     ActiveColumnsWithCoeff lp_solution_columns,
-                    std::vector<uint32_t> forbidden_columns,
+                    ColumnSet forbidden_columns,
                     std::shared_ptr<const Graph> g,
                     bool timeout = false) :
                     ub{ub},
@@ -40,7 +41,7 @@ namespace sgcp {
                 lp_solution_columns.begin(),
                 lp_solution_columns.end(),
                 [&] (auto colval) -> bool {
-                    return std::find(forbidden_columns.begin(), forbidden_columns.end(), colval.first) != forbidden_columns.end();
+                    return this->forbidden_columns.contains(colval.first);
                 }
             ));
         }
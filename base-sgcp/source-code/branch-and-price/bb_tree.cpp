@@ -3,6 +3,7 @@
 #include "initial_solutions_generator.hpp"
 #include "branching_helper.hpp"
 #include "hoshino_populator.hpp"
+#include "checkpoint.hpp"
 #include "../utils/console_colour.hpp"
 #include "../utils/dbg_output.hpp"
 #include "../utils/cache.hpp"
@@ -13,6 +14,9 @@
 #include <memory>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <limits>
+#include <thread>
 
 namespace sgcp {
     BBTree::BBTree(std::shared_ptr<const Graph> original_g) :
@@ -21,7 +25,9 @@ namespace sgcp {
         q{bb_order},
         lp_solver{*original_g, column_pool, true},
         mip_solver{*original_g, column_pool, false},
-        stats{original_g->params}
+        stats{original_g->params},
+        busy_workers{0u},
+        stop{false}
     {
         auto initial_ub = generate_initial_pool();
 
@@ -36,14 +42,11 @@ namespace sgcp {
         // 1) The root node is the product of no branching rule
         std::shared_ptr<BranchingRule> no_branching = std::make_shared<EmptyRule>(original_g);
 
-        // 2) No columns are forbidden at the root node
-        auto no_forbidden = std::vector<uint32_t>{};
+        // 2) Create the node
+        auto root_node = std::make_unique<BBNode>(original_g, no_branching, column_pool, last_node_id++, 0u, boost::none, stats);
 
-        // 3) Create the node
-        auto root_node = BBNode{original_g, no_branching, column_pool, no_forbidden, initial_solution_ids, last_node_id++, 0u, boost::none, stats};
-
-        // 4) Add it to the node queue
-        q.insert(root_node);
+        // 3) Add it to the node queue
+        q.insert(std::move(root_node));
 
         // Before solving the root node, we cannot say much on the LB...
         lb = 1;
@@ -52,6 +55,52 @@ namespace sgcp {
         ub = static_cast<float>(initial_ub);
     }
 
+    BBTree::BBTree(std::shared_ptr<const Graph> original_g, const std::string& checkpoint_file) :
+        original_g{original_g},
+        bb_order{original_g->params},
+        q{bb_order},
+        lp_solver{*original_g, column_pool, true},
+        mip_solver{*original_g, column_pool, false},
+        stats{original_g->params},
+        busy_workers{0u},
+        stop{false}
+    {
+        stats.read_instance_data(*original_g);
+
+        auto cp = Checkpoint::read(checkpoint_file, original_g, stats);
+
+        // The pool had no duplicates, so the columns keep their ids.
+        column_pool = ColumnPool{cp.columns};
+        assert(column_pool.size() == cp.columns.size());
+
+        initial_solution_ids = cp.initial_solution_ids;
+
+        for(const auto& node : cp.open_nodes) {
+            q.insert(std::make_unique<BBNode>(original_g, node.br, column_pool, node.node_id, node.depth, node.bound_from_father, stats));
+        }
+
+        best_solution = cp.best_solution;
+        ub = cp.ub;
+
+        // The global LB is recomputed as the smallest bound among the open nodes, so that
+        // a wrong saved LB is not carried over (update_bounds only ever raises it). If some
+        // open node has no bound yet, as the root, we cannot say much on the LB.
+        lb = cp.lb;
+        if(!cp.open_nodes.empty()) {
+            lb = std::numeric_limits<float>::max();
+            for(const auto& node : cp.open_nodes) {
+                if(!node.bound_from_father) { lb = 1; break; }
+                lb = std::min(lb, *node.bound_from_father);
+            }
+        }
+        last_node_id = cp.last_node_id;
+
+        // The other statistics carry on from the previous runs, but each run has its own time limit.
+        stats.tot_computing_time = 0.0f;
+
+        if(!initial_solution_ids.empty()) { mip_solver.add_mipstart(initial_solution_ids); }
+    }
+
     boost::optional<StableSetCollection> BBTree::solve() {
         using namespace Console;
 
@@ -60,17 +109,94 @@ namespace sgcp {
         std::cout << std::endl << "Node ID   LB        UB        Pool size     Open nodes" << std::endl;
         std::cout <<              "*---------*---------*---------*-------------*---------" << std::endl;
 
-        while(!q.empty()) {
-            if(stats.tot_computing_time > original_g->params.time_limit) {
-                std::cout << Colour::Red << "Time limit hit! Aborting after " << stats.tot_computing_time << " seconds." << std::endl;
-                break;
+        auto n_threads = std::max(1u, original_g->params.bb_threads);
+
+        if(n_threads == 1u) {
+            explore(lp_solver, mip_solver, stats);
+        } else {
+            // Solve the root node first, so that all threads start from its columns.
+            explore(lp_solver, mip_solver, stats, 1u);
+        }
+
+        if(n_threads > 1u && !stop && !q.empty()) {
+
+            // The first thread uses the tree's solvers, the others get their own copies
+            // of the master problems, built from the current column pool.
+            std::vector<std::unique_ptr<MpSolver>> lp_solvers, mip_solvers;
+            std::vector<SolverStats> worker_stats;
+
+            for(auto t = 0u; t < n_threads; ++t) {
+                if(t > 0u) {
+                    lp_solvers.push_back(std::make_unique<MpSolver>(*original_g, column_pool, true));
+                    mip_solvers.push_back(std::make_unique<MpSolver>(*original_g, column_pool, false));
+                    if(original_g->params.use_initial_solution) { mip_solvers.back()->add_mipstart(initial_solution_ids); }
+                }
+
+                worker_stats.emplace_back(original_g->params);
+                worker_stats.back().tot_computing_time = stats.tot_computing_time;
             }
 
-            BBNode current_node = *q.begin();
-            auto father_lb = current_node.bound_from_father;
+            worker_snapshots.resize(n_threads);
+
+            std::vector<std::thread> threads;
+
+            for(auto t = 0u; t < n_threads; ++t) {
+                auto* lp = (t == 0u) ? &lp_solver : lp_solvers[t - 1u].get();
+                auto* mip = (t == 0u) ? &mip_solver : mip_solvers[t - 1u].get();
+                threads.emplace_back([this, lp, mip, &worker_stats, t] () {
+                    explore(*lp, *mip, worker_stats[t], std::numeric_limits<uint32_t>::max(), &worker_snapshots[t]);
+                });
+            }
+
+            for(auto& thread : threads) { thread.join(); }
+            for(const auto& ws : worker_stats) { stats.merge_worker(ws); }
+            worker_snapshots.clear();
+        }
+
+        // Save the open nodes, if any, so that the run can be resumed. A run which explored
+        // the whole tree leaves no checkpoint behind.
+        if(original_g->params.checkpoint_active) {
+            if(!q.empty()) { write_checkpoint(); }
+            else { std::remove(Checkpoint::filename_for(*original_g).c_str()); }
+        }
+
+        stats.nodes_open = q.size();
+        stats.column_pool_size = column_pool.size();
+        stats.ub = ub;
+        stats.lb = lb;
+        stats.build_stats();
+
+        std::cout << std::endl << yellow_separator() << std::endl;
+        std::cout << Colour::Yellow << "BB Tree exploration completed!" << std::endl;
+        std::cout << "Lower bound: " << lb << " (=> " << std::ceil(lb) << ")" << std::endl;
+        std::cout << "Upper bound: " << ub << Colour::Default << std::endl;
+
+        if(best_solution.empty()) { return boost::none; }
+        return best_solution;
+    }
+
+    void BBTree::explore(MpSolver& lp, MpSolver& mip, SolverStats& worker_stats, uint32_t max_nodes, boost::optional<SolverStats>* snapshot) {
+        using namespace Console;
+
+        for(auto n_nodes = 0u; n_nodes < max_nodes;) {
+            std::unique_lock<std::mutex> lock{tree_mutex};
+
+            // The queue can be empty while other threads are solving nodes which will have
+            // children: the tree is only explored when no thread is busy.
+            tree_cv.wait(lock, [this] () { return stop || !q.empty() || busy_workers == 0u; });
+
+            if(stop || q.empty()) { break; }
+
+            if(worker_stats.tot_computing_time > original_g->params.time_limit) {
+                std::cout << Colour::Red << "Time limit hit! Aborting after " << worker_stats.tot_computing_time << " seconds." << std::endl;
+                stop = true;
+                tree_cv.notify_all();
+                break;
+            }
 
             // Remove node from node list.
-            q.erase(q.begin());
+            BBNode current_node = std::move(*q.extract(q.begin()).value());
+            auto father_lb = current_node.bound_from_father;
 
             DEBUG_ONLY(std::cout << Colour::Magenta << "Nodes in tree: " << q.size() + 1 << std::endl;)
             DEBUG_ONLY(std::cout << "Columns in global pool: " << column_pool.size() << Colour::Default << std::endl << std::endl;)
@@ -80,7 +206,29 @@ namespace sgcp {
                 continue;
             }
 
-            auto sol = current_node.solve(ub, lp_solver, mip_solver);
+            auto node_ub = ub;
+            ++busy_workers;
+            in_flight.insert(&current_node);
+            lock.unlock();
+
+            current_node.stats = worker_stats;
+            auto sol = current_node.solve(node_ub, lp, mip);
+            ++n_nodes;
+
+            // The branching decision is taken outside of the lock, as it scans the node's
+            // solution and columns; the lock is only taken to queue the children. If another
+            // thread has improved the UB in the meantime, they are pruned when popped.
+            if(sol && !sol->timeout && sol->lb <= node_ub + eps && !sol->node_solved_to_optimality()) {
+                DEBUG_ONLY(std::cout << Colour::Magenta << "Solution fractional at the node: lb = " << sol->lb << ", ub = " << sol->ub << "." << Colour::Default << std::endl << std::endl;)
+                branch(current_node, *sol);
+            }
+
+            lock.lock();
+            --busy_workers;
+            in_flight.erase(&current_node);
+            tree_cv.notify_all();
+
+            if(snapshot) { snapshot->emplace(worker_stats); }
 
             stats.max_depth_explored = std::max(current_node.depth, stats.max_depth_explored);
 
@@ -114,9 +262,6 @@ namespace sgcp {
                             std::cout << std::endl;
                         )
                     }
-                } else {
-                    DEBUG_ONLY(std::cout << Colour::Magenta << "Solution fractional at the node: lb = " << sol->lb << ", ub = " << sol->ub << "." << Colour::Default << std::endl << std::endl;)
-                    branch(current_node, *sol);
                 }
 
                 // Update bounds
@@ -130,6 +275,11 @@ namespace sgcp {
                     std::cout << std::setw(14) << column_pool.size();
                     std::cout << q.size() << std::endl;
                 }
+
+                auto every_n_nodes = original_g->params.checkpoint_every_n_nodes;
+                if(original_g->params.checkpoint_active && every_n_nodes > 0u && stats.nodes_solved % every_n_nodes == 0u) {
+                    write_checkpoint();
+                }
             } else {
                 // If the node timed-out, it can have given us a new UB, if it solved the MIP
                 if(sol->ub < ub) {
@@ -138,34 +288,34 @@ namespace sgcp {
                     for(auto cidval : sol->integer_solution_columns) { best_solution.push_back(column_pool.at(cidval.first)); }
                 }
 
-                // However, it can also give us info on the LB, if we calculated the Lagrangean bound
-                if(sol->lb > lb) { lb = sol->lb; }
+                // Its Lagrangian bound (if any) only holds for its own subtree, so it does not
+                // change the global LB, which is the smallest bound among the open nodes.
 
-                // Here we just let the loop continue, as at the next iteration it will realise
-                // that a timeout occurred and will exit graciously. We don't delete the current
-                // node, so to leave it open in the tree.
+                // Put the node back in the queue, so that it is left open in the tree (and
+                // saved in the checkpoint). Here we just let the loop continue, as at the next
+                // iteration it will realise that a timeout occurred and will exit graciously.
+                q.insert(std::make_unique<BBNode>(original_g, current_node.br, column_pool, current_node.node_id, current_node.depth, current_node.bound_from_father, stats));
                 continue;
             }
         }
+    }
 
-        stats.nodes_open = q.size();
-        stats.column_pool_size = column_pool.size();
-        stats.ub = ub;
-        stats.lb = lb;
-        stats.build_stats();
+    void BBTree::update_bounds(const BBSolution& sol) {
+        // The global LB is the smallest bound among the open nodes, including those being
+        // solved by other threads. It is only known if all of them have a bound.
+        float open_lb = std::numeric_limits<float>::max();
+        bool all_bounded = true;
 
-        std::cout << std::endl << yellow_separator() << std::endl;
-        std::cout << Colour::Yellow << "BB Tree exploration completed!" << std::endl;
-        std::cout << "Lower bound: " << lb << " (=> " << std::ceil(lb) << ")" << std::endl;
-        std::cout << "Upper bound: " << ub << Colour::Default << std::endl;
+        auto visit = [&] (const BBNode& n) {
+            if(!n.bound_from_father) { all_bounded = false; }
+            else { open_lb = std::min(open_lb, *n.bound_from_father); }
+        };
 
-        if(best_solution.empty()) { return boost::none; }
-        return best_solution;
-    }
+        for(const auto& n : q) { visit(*n); }
+        for(const auto* n : in_flight) { visit(*n); }
 
-    void BBTree::update_bounds(const BBSolution& sol) {
-        if(!q.empty() && q.begin()->bound_from_father) { lb = std::max(lb, *(q.begin()->bound_from_father)); }
-        else { lb = std::max(lb, sol.lb); }
+        if(q.empty() && in_flight.empty()) { lb = std::max(lb, sol.lb); }
+        else if(all_bounded) { lb = std::max(lb, open_lb); }
 
         if(sol.ub < ub) {
             ub = sol.ub;
@@ -209,19 +359,24 @@ namespace sgcp {
 
         // Create the first branch: colour chosen_id
         std::vector<uint32_t> chosen_vertex_id = {part_and_vertex->second};
-        std::shared_ptr<BranchingRule> vr1 = std::make_shared<VerticesRemoveRule>(sol.g, chosen_vertex_id);
-        BBNode new_node_1{original_g, vr1, column_pool, n.forbidden_columns, initial_solution_ids, last_node_id++, n.depth + 1, sol.lb, stats};
+        std::shared_ptr<BranchingRule> vr1 = std::make_shared<VerticesRemoveRule>(n.br, *g, chosen_vertex_id);
+        auto new_node_1 = std::make_unique<BBNode>(original_g, vr1, column_pool, last_node_id++, n.depth + 1, sol.lb, stats);
 
         // Create the second branch: colour a node != chosen_id
         std::vector<uint32_t> other_vertices_id;
         for(const auto& v_id : g->p[part_and_vertex->first]) {
             if(v_id != part_and_vertex->second) { other_vertices_id.push_back(v_id); }
         }
-        std::shared_ptr<BranchingRule> vr2 = std::make_shared<VerticesRemoveRule>(sol.g, other_vertices_id);
-        BBNode new_node_2{original_g, vr2, column_pool, n.forbidden_columns, initial_solution_ids, last_node_id++, n.depth + 1, sol.lb, stats};
+        std::shared_ptr<BranchingRule> vr2 = std::make_shared<VerticesRemoveRule>(n.br, *g, other_vertices_id);
+        auto new_node_2 = std::make_unique<BBNode>(original_g, vr2, column_pool, last_node_id++, n.depth + 1, sol.lb, stats);
+
+        std::lock_guard<std::mutex> lock{tree_mutex};
 
-        q.insert(new_node_1);
-        q.insert(new_node_2);
+        q.insert(std::move(new_node_1));
+        q.insert(std::move(new_node_2));
+
+        // The father is replaced by its children, as far as checkpoints are concerned.
+        in_flight.erase(&n);
 
         stats.n_branch_on_coloured_v++;
 
@@ -239,7 +394,7 @@ namespace sgcp {
         auto column1_id = bh.most_fractional_column();
 
         // Second, find any vertex covered by the column
-        auto id_i = bh.any_vertex_in_set(column_pool.at(column1_id).get_set());
+        auto id_i = bh.any_vertex_in_set(column_pool.at(column1_id));
         assert(id_i);
 
         auto column2_id = bh.another_column_covering_vertex(column1_id, *id_i);
@@ -262,14 +417,20 @@ namespace sgcp {
         DEBUG_ONLY(std::cout << yellow_separator() << Colour::Default << std::endl << std::endl;)
 
         // Create the first branch: merge i and j
-        std::shared_ptr<BranchingRule> vm = std::make_shared<VerticesMergeRule>(g, *id_i, *id_j);
-        BBNode new_node_1{original_g, vm, column_pool, n.forbidden_columns, initial_solution_ids, last_node_id++, n.depth + 1, sol.lb, stats};
-        q.insert(new_node_1);
+        std::shared_ptr<BranchingRule> vm = std::make_shared<VerticesMergeRule>(n.br, *g, *id_i, *id_j);
+        auto new_node_1 = std::make_unique<BBNode>(original_g, vm, column_pool, last_node_id++, n.depth + 1, sol.lb, stats);
 
         // Create the second branch: link i and j
-        std::shared_ptr<BranchingRule> vl = std::make_shared<VerticesLinkRule>(g, *id_i, *id_j);
-        BBNode new_node_2{original_g, vl, column_pool, n.forbidden_columns, initial_solution_ids, last_node_id++, n.depth + 1, sol.lb, stats};
-        q.insert(new_node_2);
+        std::shared_ptr<BranchingRule> vl = std::make_shared<VerticesLinkRule>(n.br, *g, *id_i, *id_j);
+        auto new_node_2 = std::make_unique<BBNode>(original_g, vl, column_pool, last_node_id++, n.depth + 1, sol.lb, stats);
+
+        std::lock_guard<std::mutex> lock{tree_mutex};
+
+        q.insert(std::move(new_node_1));
+        q.insert(std::move(new_node_2));
+
+        // The father is replaced by its children, as far as checkpoints are concerned.
+        in_flight.erase(&n);
 
         stats.n_branch_on_edge++;
 
@@ -300,7 +461,7 @@ namespace sgcp {
             if(original_g->params.use_populate) {
                 HoshinoPopulator pop{*original_g, column_pool};
                 auto pop_columns = pop.enlarge_pool();
-                for (const auto &c : pop_columns) { column_pool.push_back(c); }
+                column_pool.insert(pop_columns.get_columns());
             }
 
             // Check the bks
@@ -309,10 +470,9 @@ namespace sgcp {
 
         // Add the dummy column
         auto dummy_col = StableSet{*original_g};
-        column_pool.push_back(dummy_col);
+        column_pool.insert(dummy_col);
 
-        // Add the columns to the LP and MIP
-        for(const auto& c : column_pool) { lp_solver.add_column(c); mip_solver.add_column(c); }
+        // The LP and the MIP get the columns from the pool when first used.
 
         // Use the best initial solution as a MIPstart
         if(original_g->params.use_initial_solution) {
@@ -325,6 +485,27 @@ namespace sgcp {
         return stats.heuristic_ub;
     }
 
+    void BBTree::write_checkpoint() const {
+        Checkpoint cp;
+
+        cp.columns = column_pool.get_columns();
+        cp.initial_solution_ids = initial_solution_ids;
+
+        for(const auto& node : q) { cp.open_nodes.push_back({node->br, node->node_id, node->depth, node->bound_from_father}); }
+        for(const auto* node : in_flight) { cp.open_nodes.push_back({node->br, node->node_id, node->depth, node->bound_from_father}); }
+
+        cp.best_solution = best_solution;
+        cp.lb = lb;
+        cp.ub = ub;
+        cp.last_node_id = last_node_id;
+
+        // The workers' statistics are only merged in the tree's ones when they are done.
+        SolverStats cp_stats{stats};
+        for(const auto& ws : worker_snapshots) { if(ws) { cp_stats.merge_worker(*ws); } }
+
+        cp.write(Checkpoint::filename_for(*original_g), *original_g, cp_stats);
+    }
+
     void BBTree::write_results() const {
         stats.write_csv();
     }
@@ -8,10 +8,15 @@
 
 #include <queue>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
 
 #include <vector>
 #include <set>
 #include <map>
+#include <string>
 
 namespace sgcp {
     struct BestFirstOrder {
@@ -43,6 +48,8 @@ namespace sgcp {
             if(p.bb_exploration_strategy == BBExplorationStrategy::DepthFirst) { return df(lhs, rhs); }
             return bf(lhs,rhs);
         }
+
+        bool operator()(const std::unique_ptr<BBNode>& lhs, const std::unique_ptr<BBNode>& rhs) const { return (*this)(*lhs, *rhs); }
     };
 
     class BBTree {
@@ -50,7 +57,8 @@ namespace sgcp {
         ColumnPool column_pool;
 
         BBOrder bb_order;
-        std::set<BBNode, BBOrder> q;
+        // Open nodes. They are kept on the heap, so that the queue only moves pointers around.
+        std::set<std::unique_ptr<BBNode>, BBOrder> q;
         std::vector<uint32_t> initial_solution_ids;
 
         MpSolver lp_solver;
@@ -61,13 +69,47 @@ namespace sgcp {
         StableSetCollection best_solution;
 
         // Node id of the last created node.
-        uint32_t last_node_id;
+        std::atomic<uint32_t> last_node_id;
 
         SolverStats stats;
 
+        // When the tree is explored by more than one thread, this protects the node queue,
+        // the bounds, the best solution and the tree-wide statistics (the number of nodes
+        // solved and branchings made). Each thread has its own master problem solvers and
+        // keeps its own timing and column generation statistics.
+        std::mutex tree_mutex;
+        std::condition_variable tree_cv;
+
+        // Number of threads currently solving a node.
+        uint32_t busy_workers;
+
+        // Set when a thread hits the time limit, so that the others stop too.
+        bool stop;
+
+        // Nodes popped from the queue and currently being solved. They are still
+        // open, as far as checkpoints are concerned.
+        std::set<const BBNode*> in_flight;
+
+        // Copies of the statistics of the threads exploring the tree, which each thread
+        // updates under tree_mutex after every node it solves, so that checkpoints written
+        // while they run include them. Empty when the tree is explored by a single thread.
+        std::vector<boost::optional<SolverStats>> worker_snapshots;
+
         static constexpr float eps = 1e-6;
 
         uint32_t generate_initial_pool();
+
+        // Saves the current state of the tree in the instance's checkpoint file. When more
+        // than one thread explores the tree, the caller must hold tree_mutex.
+        void write_checkpoint() const;
+
+        // Pops and solves nodes until the tree is explored, the time limit is hit, or
+        // max_nodes nodes have been solved. Can be run by multiple threads at once, in
+        // which case each thread copies its statistics in its snapshot after every node.
+        void explore(   MpSolver& lp, MpSolver& mip, SolverStats& worker_stats,
+                        uint32_t max_nodes = std::numeric_limits<uint32_t>::max(),
+                        boost::optional<SolverStats>* snapshot = nullptr);
+
         void update_bounds(const BBSolution& sol);
         void branch(const BBNode& n, const BBSolution& sol);
         bool branch_on_vertex_in_partition(const BBNode& n, const BBSolution& sol);
@@ -76,6 +118,9 @@ namespace sgcp {
     public:
         BBTree(std::shared_ptr<const Graph> original_g);
 
+        // Resumes a run from a checkpoint file, skipping the initial heuristics.
+        BBTree(std::shared_ptr<const Graph> original_g, const std::string& checkpoint_file);
+
         boost::optional<StableSetCollection> solve();
         void write_results() const;
     };
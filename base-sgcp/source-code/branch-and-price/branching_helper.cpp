@@ -3,51 +3,35 @@
 #include <stdexcept>
 
 namespace sgcp {
-    uint32_t BranchingHelper::how_many_intersections(uint32_t k, const VertexIdSet& s) const {
-        VertexIdSet local_vertices_intersected;
-
-        for(auto i : s) {
-            for(auto v_id : g.p[k]) {
-                auto v = g.vertex_by_id(v_id);
-                assert(v);
-
-                if(g.g[*v].represents(i)) { local_vertices_intersected.insert(v_id); }
-            }
-        }
-        return local_vertices_intersected.size();
+    uint32_t BranchingHelper::how_many_intersections(uint32_t k, const StableSet& s) const {
+        return std::count_if(
+            g.p[k].begin(),
+            g.p[k].end(),
+            [&] (uint32_t v_id) -> bool { return is_vertex_in_set(v_id, s); }
+        );
     }
 
-    boost::optional<uint32_t> BranchingHelper::any_vertex_in_intersection(uint32_t k, const VertexIdSet& s) const {
-        for(auto i : s) {
-            for(auto v_id : g.p[k]) {
-                auto v = g.vertex_by_id(v_id);
-                assert(v);
-
-                if(g.g[*v].represents(i)) { return v_id; }
-            }
+    boost::optional<uint32_t> BranchingHelper::any_vertex_in_intersection(uint32_t k, const StableSet& s) const {
+        for(auto v_id : g.p[k]) {
+            if(is_vertex_in_set(v_id, s)) { return v_id; }
         }
         return boost::none;
     }
 
-    boost::optional<uint32_t> BranchingHelper::any_vertex_in_set(const VertexIdSet& s) const {
-        for(auto i : s) {
-            for(auto it = vertices(g.g); it.first != it.second; ++it.first) {
-                Vertex v = *it.first;
-                if(g.g[v].represents(i)) { return g.g[v].id; }
-            }
+    boost::optional<uint32_t> BranchingHelper::any_vertex_in_set(const StableSet& s) const {
+        for(auto i : s.get_set()) {
+            auto v = g.vertex_by_original_id(i);
+            if(v) { return g.g[*v].id; }
         }
         return boost::none;
     }
 
-    bool BranchingHelper::is_vertex_in_set(uint32_t id, const VertexIdSet& s) const {
+    bool BranchingHelper::is_vertex_in_set(uint32_t id, const StableSet& s) const {
         auto v = g.vertex_by_id(id);
         if(!v) { return false; }
 
-        for(auto rid : g.g[*v].represented_vertices) {
-            if(std::find(s.begin(), s.end(), rid) != s.end()) { return true; }
-        }
-
-        return false;
+        const auto& v_rep = g.g[*v].represented_vertices;
+        return std::any_of(v_rep.begin(), v_rep.end(), [&] (uint32_t rid) { return s.has_vertex(rid); });
     }
 
     boost::optional<uint32_t> BranchingHelper::any_vertex_covered_by_exactly_one_column(uint32_t c1, uint32_t c2) const {
@@ -55,8 +39,8 @@ namespace sgcp {
             throw std::runtime_error("any_vertex_covered_by_exactly_one_column: One of the selected columns is dummy!");
         }
         
-        const auto& s1 = column_pool.at(c1).get_set();
-        const auto& s2 = column_pool.at(c2).get_set();
+        const auto& s1 = column_pool.at(c1);
+        const auto& s2 = column_pool.at(c2);
 
         for(auto it = vertices(g.g); it.first != it.second; ++it.first) {
             Vertex v = *it.first;
@@ -84,11 +68,11 @@ namespace sgcp {
                     throw std::runtime_error("mark_coloured_vertices_by_lp_solution: Base solution contains dummy column");
                 }
                 
-                const auto& s = column_pool.at(cidval.first).get_set();
+                const auto& s = column_pool.at(cidval.first);
                 if(std::any_of( v_rep.begin(),
                                 v_rep.end(),
                                 [&] (auto rep_id) {
-                                    return std::find(s.begin(), s.end(), rep_id) != s.end();
+                                    return s.has_vertex(rep_id);
                                 }))
                 { coloured_vertices[v_id] = true; break; }
             }
@@ -153,10 +137,10 @@ namespace sgcp {
                 throw std::runtime_error("vertex_in_most_fractional_column_that_covers_partition: Base solution contains dummy column!");
             }
 
-            if(how_many_intersections(part_k, s.get_set()) > 0u && fractionality < fract_value - eps) {
+            if(how_many_intersections(part_k, s) > 0u && fractionality < fract_value - eps) {
                 fract_value = fractionality;
 
-                auto vid = any_vertex_in_intersection(part_k, s.get_set());
+                auto vid = any_vertex_in_intersection(part_k, s);
                 assert(vid);
                 chosen_id = *vid;
             }
@@ -184,9 +168,9 @@ namespace sgcp {
                 float v_fractionality = 0.0f;
 
                 for(auto cidval : sol.lp_solution_columns) {
-                    const auto& s = column_pool.at(cidval.first).get_set();
+                    const auto& s = column_pool.at(cidval.first);
 
-                    if(cidval.second > eps && std::any_of(v_rep.begin(), v_rep.end(), [&] (auto rep_id) { return std::find(s.begin(), s.end(), rep_id) != s.end(); })) {
+                    if(cidval.second > eps && std::any_of(v_rep.begin(), v_rep.end(), [&] (auto rep_id) { return s.has_vertex(rep_id); })) {
                         coloured_vertices.insert(v_id);
                         v_fractionality += cidval.second;
                     }
@@ -244,7 +228,7 @@ namespace sgcp {
             throw std::runtime_error("another_column_covering_vertex: Base solution contains first column which is dummy!");
         }
         
-        assert(is_vertex_in_set(vertex_id, column_pool.at(column1_id).get_set()));
+        assert(is_vertex_in_set(vertex_id, column_pool.at(column1_id)));
 
         uint32_t column2_id = column_pool.size();
 
@@ -258,7 +242,7 @@ namespace sgcp {
             );
 
             if(it != sol.lp_solution_columns.end()) {
-                if(is_vertex_in_set(vertex_id, column_pool.at(cid).get_set())) {
+                if(is_vertex_in_set(vertex_id, column_pool.at(cid))) {
                     column2_id = cid;
                     break;
                 }
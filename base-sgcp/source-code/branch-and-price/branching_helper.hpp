@@ -18,17 +18,17 @@ namespace sgcp {
         const BBSolution& sol;
         const ColumnPool& column_pool;
 
-        // Returns how many vertices of a given partition are coloured by a given set of vertices.
-        // The ids in the set of vertices refer to the original ids.
-        uint32_t how_many_intersections(uint32_t k, const VertexIdSet& s) const;
+        // Returns how many vertices of a given partition are coloured by a given stable set.
+        // The ids in the stable set refer to the original ids.
+        uint32_t how_many_intersections(uint32_t k, const StableSet& s) const;
 
-        // Returns any vertex in the intersection between the k-th partition and the given set of vertices.
-        // The ids in the set of vertices refer to the original ids.
-        boost::optional<uint32_t> any_vertex_in_intersection(uint32_t k, const VertexIdSet& s) const;
+        // Returns any vertex in the intersection between the k-th partition and the given stable set.
+        // The ids in the stable set refer to the original ids.
+        boost::optional<uint32_t> any_vertex_in_intersection(uint32_t k, const StableSet& s) const;
 
-        // Tells if a given set contains a certain vertex (by id).
+        // Tells if a given stable set contains a certain vertex (by id).
         // The vertex id refers to the current ids, but the set ids refer to the original ones.
-        bool is_vertex_in_set(uint32_t id, const VertexIdSet& s) const;
+        bool is_vertex_in_set(uint32_t id, const StableSet& s) const;
 
         // Tells, for each vertex, if there is (at least) one column in the LP solution that covers it.
         std::map<uint32_t, bool> mark_coloured_vertices_by_lp_solution() const;
@@ -52,7 +52,7 @@ namespace sgcp {
         // Returns any vertex of the graph contained in the given set, if any (remember
         // some vertices are removed during the branching process). The ids in the set
         // refer to the original ids.
-        boost::optional<uint32_t> any_vertex_in_set(const VertexIdSet& s) const;
+        boost::optional<uint32_t> any_vertex_in_set(const StableSet& s) const;
 
         // Finds any vertex that is part of exactly one of the two provided columns.
         // The ids in the sets of vertices (in the columns) refer to the original ids.
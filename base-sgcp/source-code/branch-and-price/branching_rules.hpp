@@ -2,76 +2,114 @@
 #define _BRANCHING_RULES_HPP
 
 #include "../graph.hpp"
-#include "../stable_set.hpp"
+#include "graph_overlay.hpp"
 
+#include <cstdint>
 #include <set>
 #include <memory>
 #include <vector>
 
 namespace sgcp {
+    // A branching rule records the decision which generated a B&B node, in terms of
+    // original vertex ids, together with the rule which generated its father. The
+    // local graph of the node is obtained applying all the decisions on the path from
+    // the root to the original graph, so no intermediate graph needs to be kept alive.
     class BranchingRule {
     protected:
-        std::shared_ptr<const Graph> g;
+        // Original graph, before any branching rules modified it.
+        std::shared_ptr<const Graph> o;
 
-        // Tells if the vertex (given by its current id) is contained
-        // in a set of vertices (given by their original ids).
-        bool vertex_in_set(uint32_t id, const VertexIdSet& s) const;
+        // Rule which generated the father node (nullptr at the root).
+        std::shared_ptr<const BranchingRule> parent;
+
+        // Original ids of the vertices represented by the vertex with the given (current) id.
+        static std::vector<uint32_t> represented_by(const Graph& g, uint32_t id);
 
     public:
-        BranchingRule(std::shared_ptr<const Graph> g) : g{g} {}
+        enum class Type : uint8_t { Empty, VerticesRemove, VerticesLink, VerticesMerge };
+
+        BranchingRule(std::shared_ptr<const Graph> o, std::shared_ptr<const BranchingRule> parent) : o{o}, parent{parent} {}
+        virtual ~BranchingRule() = default;
+
+        // Builds a rule of the given type out of its decision, as returned by decision().
+        static std::shared_ptr<const BranchingRule> make(   std::shared_ptr<const Graph> o,
+                                                            std::shared_ptr<const BranchingRule> parent,
+                                                            Type type,
+                                                            const std::vector<std::vector<uint32_t>>& decision);
+
+        std::shared_ptr<const Graph> original_graph() const { return o; }
+        const std::shared_ptr<const BranchingRule>& get_parent() const { return parent; }
+
+        // Type of the rule and original ids of the vertices involved in its decision,
+        // so that the rule can be saved and rebuilt without the father's graph.
+        virtual Type type() const = 0;
+        virtual std::vector<std::vector<uint32_t>> decision() const = 0;
 
-        // Apply the rule to a graph, obtaining a new graph
-        virtual std::shared_ptr<const Graph> apply() const = 0;
+        // Records the decision of this rule (only) in the overlay.
+        virtual void add_to(GraphOverlay& overlay) const = 0;
 
-        // Checks if the given stable set is compatible with the branching rule
-        // (and therefore can stay in the column pool of the corresponding B&B node).
-        virtual bool is_compatible(const StableSet& s) const = 0;
+        // Builds the overlay with the decisions of this rule and all its ancestors.
+        GraphOverlay overlay() const;
     };
 
     // Does noting
     class EmptyRule : public BranchingRule {
     public:
-        EmptyRule(std::shared_ptr<const Graph> g) : BranchingRule{g} {}
-        std::shared_ptr<const Graph> apply() const { return g; }
-        bool is_compatible(const StableSet& s [[maybe_unused]]) const { return true; }
+        EmptyRule(std::shared_ptr<const Graph> o) : BranchingRule{o, nullptr} {}
+        Type type() const { return Type::Empty; }
+        std::vector<std::vector<uint32_t>> decision() const { return {}; }
+        void add_to(GraphOverlay& overlay [[maybe_unused]]) const {}
     };
 
+    // The rules below take the father's local graph and the ids of the vertices to
+    // branch on in that graph, and translate them into original ids.
+
     // Removes certain vertices from the graph
     class VerticesRemoveRule : public BranchingRule {
-        std::vector<uint32_t> vertices_id;
+        // Original ids of all the vertices represented by the removed ones.
+        std::vector<uint32_t> removed_ids;
 
     public:
-        VerticesRemoveRule(std::shared_ptr<const Graph> g, std::vector<uint32_t> vertices_id) : BranchingRule(g), vertices_id{vertices_id} {
-            // Check that all elements of vertices_id are unique.
-            assert(std::set<uint32_t>(vertices_id.begin(), vertices_id.end()).size() == vertices_id.size());
-        }
+        VerticesRemoveRule(std::shared_ptr<const BranchingRule> parent, const Graph& g, const std::vector<uint32_t>& vertices_id);
+        VerticesRemoveRule(std::shared_ptr<const BranchingRule> parent, std::vector<uint32_t> removed_ids) :
+            BranchingRule{parent->original_graph(), parent}, removed_ids{removed_ids} {}
+
+        Type type() const { return Type::VerticesRemove; }
+        std::vector<std::vector<uint32_t>> decision() const { return {removed_ids}; }
 
-        std::shared_ptr<const Graph> apply() const;
-        bool is_compatible(const StableSet& s) const;
+        void add_to(GraphOverlay& overlay) const;
     };
 
     // Connects two vertices in the graph
     class VerticesLinkRule : public BranchingRule {
-        uint32_t i1;
-        uint32_t i2;
+        std::vector<uint32_t> ids1;
+        std::vector<uint32_t> ids2;
 
     public:
-        VerticesLinkRule(std::shared_ptr<const Graph> g, uint32_t i1, uint32_t i2) : BranchingRule(g), i1{i1}, i2{i2} { assert(i1 != i2); }
+        VerticesLinkRule(std::shared_ptr<const BranchingRule> parent, const Graph& g, uint32_t i1, uint32_t i2);
+        VerticesLinkRule(std::shared_ptr<const BranchingRule> parent, std::vector<uint32_t> ids1, std::vector<uint32_t> ids2) :
+            BranchingRule{parent->original_graph(), parent}, ids1{ids1}, ids2{ids2} {}
 
-        std::shared_ptr<const Graph> apply() const;
-        bool is_compatible(const StableSet& s) const;
+        Type type() const { return Type::VerticesLink; }
+        std::vector<std::vector<uint32_t>> decision() const { return {ids1, ids2}; }
+
+        void add_to(GraphOverlay& overlay) const;
     };
 
     class VerticesMergeRule : public BranchingRule {
-        uint32_t i1;
-        uint32_t i2;
+        std::vector<uint32_t> ids1;
+        std::vector<uint32_t> ids2;
 
     public:
-        VerticesMergeRule(std::shared_ptr<const Graph> g, uint32_t i1, uint32_t i2) : BranchingRule(g), i1{i1}, i2{i2} { assert(i1 != i2); }
+        VerticesMergeRule(std::shared_ptr<const BranchingRule> parent, const Graph& g, uint32_t i1, uint32_t i2);
+        VerticesMergeRule(std::shared_ptr<const BranchingRule> parent, std::vector<uint32_t> ids1, std::vector<uint32_t> ids2) :
+            BranchingRule{parent->original_graph(), parent}, ids1{ids1}, ids2{ids2} {}
+
+        Type type() const { return Type::VerticesMerge; }
+        std::vector<std::vector<uint32_t>> decision() const { return {ids1, ids2}; }
 
-        std::shared_ptr<const Graph> apply() const;
-        bool is_compatible(const StableSet& s) const;
+        void add_to(GraphOverlay& overlay) const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,175 @@
+#include "checkpoint.hpp"
+#include "../utils/binary_io.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sgcp {
+    namespace {
+        constexpr char magic[8] = {'S', 'G', 'C', 'P', 'C', 'K', 'P', '1'};
+        constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+
+        void write_sets(std::ostream& out, const StableSetCollection& sets) {
+            binary_io::write(out, static_cast<uint32_t>(sets.size()));
+            for(const auto& s : sets) {
+                binary_io::write(out, static_cast<uint8_t>(s.dummy));
+                binary_io::write_vector(out, s.get_set());
+            }
+        }
+
+        StableSetCollection read_sets(std::istream& in, const Graph& g) {
+            StableSetCollection sets;
+            auto n_sets = binary_io::read<uint32_t>(in);
+            sets.reserve(n_sets);
+
+            for(auto i = 0u; i < n_sets; ++i) {
+                auto dummy = binary_io::read<uint8_t>(in) != 0u;
+                auto ids = binary_io::read_vector<uint32_t>(in);
+
+                if(dummy) { sets.emplace_back(g); continue; }
+
+                for(auto id : ids) {
+                    if(id >= g.n_vertices) { throw std::runtime_error("Checkpoint refers to a vertex not in the graph"); }
+                }
+                sets.emplace_back(g, ids);
+            }
+
+            return sets;
+        }
+    }
+
+    std::string Checkpoint::filename_for(const Graph& g) {
+        auto instance = g.data_filename.substr(g.data_filename.find_last_of('/') + 1u);
+        instance = instance.substr(0, instance.find_last_of('.'));
+        return g.params.results_dir + "/" + instance + ".checkpoint";
+    }
+
+    void Checkpoint::write(const std::string& filename, const Graph& g, const SolverStats& stats) const {
+        auto tmp_filename = filename + ".tmp";
+        std::ofstream out(tmp_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        out.write(magic, sizeof(magic));
+        binary_io::write(out, g.n_vertices);
+        binary_io::write(out, g.n_edges);
+        binary_io::write(out, g.n_partitions);
+
+        write_sets(out, columns);
+        binary_io::write_vector(out, initial_solution_ids);
+
+        // Open nodes share the rules of their common ancestors: each rule is written once,
+        // after its parent, and refers to it by its position in the file.
+        std::unordered_map<const BranchingRule*, uint32_t> rule_index;
+        std::vector<const BranchingRule*> rules;
+
+        for(const auto& node : open_nodes) {
+            std::vector<const BranchingRule*> path;
+            for(auto rule = node.br.get(); rule != nullptr && rule_index.count(rule) == 0u; rule = rule->get_parent().get()) {
+                path.push_back(rule);
+            }
+            for(auto it = path.rbegin(); it != path.rend(); ++it) {
+                rule_index[*it] = rules.size();
+                rules.push_back(*it);
+            }
+        }
+
+        binary_io::write(out, static_cast<uint32_t>(rules.size()));
+        for(const auto* rule : rules) {
+            binary_io::write(out, rule->type());
+            binary_io::write(out, rule->get_parent() ? rule_index.at(rule->get_parent().get()) : no_parent);
+
+            auto decision = rule->decision();
+            binary_io::write(out, static_cast<uint32_t>(decision.size()));
+            for(const auto& ids : decision) { binary_io::write_vector(out, ids); }
+        }
+
+        binary_io::write(out, static_cast<uint32_t>(open_nodes.size()));
+        for(const auto& node : open_nodes) {
+            binary_io::write(out, rule_index.at(node.br.get()));
+            binary_io::write(out, node.node_id);
+            binary_io::write(out, node.depth);
+            binary_io::write(out, static_cast<uint8_t>(node.bound_from_father ? 1u : 0u));
+            binary_io::write(out, node.bound_from_father ? *node.bound_from_father : 0.0f);
+        }
+
+        write_sets(out, best_solution);
+        binary_io::write(out, lb);
+        binary_io::write(out, ub);
+        binary_io::write(out, last_node_id);
+
+        stats.write_binary(out);
+
+        out.close();
+        if(!out) { throw std::runtime_error("Cannot write checkpoint file: " + tmp_filename); }
+
+        if(std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+            throw std::runtime_error("Cannot rename checkpoint file to: " + filename);
+        }
+    }
+
+    Checkpoint Checkpoint::read(const std::string& filename, std::shared_ptr<const Graph> g, SolverStats& stats) {
+        std::ifstream in(filename, std::ios::in | std::ios::binary);
+        if(!in) { throw std::runtime_error("Cannot open checkpoint file: " + filename); }
+
+        char file_magic[sizeof(magic)];
+        in.read(file_magic, sizeof(file_magic));
+        if(!in || std::memcmp(file_magic, magic, sizeof(magic)) != 0) { throw std::runtime_error("Not a checkpoint file: " + filename); }
+
+        auto n_vertices = binary_io::read<uint32_t>(in);
+        auto n_edges = binary_io::read<uint32_t>(in);
+        auto n_partitions = binary_io::read<uint32_t>(in);
+
+        if(n_vertices != g->n_vertices || n_edges != g->n_edges || n_partitions != g->n_partitions) {
+            throw std::runtime_error("Checkpoint file is for a different instance: " + filename);
+        }
+
+        Checkpoint cp;
+
+        cp.columns = read_sets(in, *g);
+        cp.initial_solution_ids = binary_io::read_vector<uint32_t>(in);
+
+        std::vector<std::shared_ptr<const BranchingRule>> rules(binary_io::read<uint32_t>(in));
+        for(auto& rule : rules) {
+            auto type = binary_io::read<BranchingRule::Type>(in);
+            auto parent_id = binary_io::read<uint32_t>(in);
+
+            std::vector<std::vector<uint32_t>> decision(binary_io::read<uint32_t>(in));
+            for(auto& ids : decision) { ids = binary_io::read_vector<uint32_t>(in); }
+
+            std::shared_ptr<const BranchingRule> parent;
+            if(parent_id != no_parent) {
+                // Parents are always written before their children.
+                if(parent_id >= static_cast<uint32_t>(&rule - rules.data())) { throw std::runtime_error("Corrupted checkpoint file: " + filename); }
+                parent = rules[parent_id];
+            }
+
+            rule = BranchingRule::make(g, parent, type, decision);
+        }
+
+        cp.open_nodes.resize(binary_io::read<uint32_t>(in));
+        for(auto& node : cp.open_nodes) {
+            auto rule_id = binary_io::read<uint32_t>(in);
+            if(rule_id >= rules.size()) { throw std::runtime_error("Corrupted checkpoint file: " + filename); }
+
+            node.br = rules[rule_id];
+            node.node_id = binary_io::read<uint32_t>(in);
+            node.depth = binary_io::read<uint32_t>(in);
+
+            auto has_bound = binary_io::read<uint8_t>(in) != 0u;
+            auto bound = binary_io::read<float>(in);
+            if(has_bound) { node.bound_from_father = bound; }
+        }
+
+        cp.best_solution = read_sets(in, *g);
+        cp.lb = binary_io::read<float>(in);
+        cp.ub = binary_io::read<float>(in);
+        cp.last_node_id = binary_io::read<uint32_t>(in);
+
+        stats.read_binary(in);
+
+        return cp;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef _CHECKPOINT_HPP
+#define _CHECKPOINT_HPP
+
+#include "../graph.hpp"
+#include "../stable_set.hpp"
+#include "../solver_stats.hpp"
+#include "branching_rules.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace sgcp {
+    // State of a branch-and-price run, from which it can be resumed: the column pool,
+    // the open nodes (as the branching decisions leading to them, plus their bounds),
+    // the incumbent and the statistics. It is saved in a binary file, whose vertex ids
+    // refer to the preprocessed graph, so it can only be read back for the same
+    // instance, preprocessed in the same way.
+    struct Checkpoint {
+        struct OpenNode {
+            std::shared_ptr<const BranchingRule> br;
+            uint32_t node_id;
+            uint32_t depth;
+            boost::optional<float> bound_from_father;
+        };
+
+        StableSetCollection columns;
+        std::vector<uint32_t> initial_solution_ids;
+        std::vector<OpenNode> open_nodes;
+        StableSetCollection best_solution;
+        float lb;
+        float ub;
+        uint32_t last_node_id;
+
+        // Name of the checkpoint file of an instance: it is in the results directory,
+        // named after the instance file.
+        static std::string filename_for(const Graph& g);
+
+        // Writes the checkpoint, together with the statistics. The file is first written
+        // under a temporary name and then renamed, so an interrupted write does not
+        // destroy the previous checkpoint.
+        void write(const std::string& filename, const Graph& g, const SolverStats& stats) const;
+
+        // Reads a checkpoint, filling in the statistics. Throws if the file is not
+        // a valid checkpoint for graph g.
+        static Checkpoint read(const std::string& filename, std::shared_ptr<const Graph> g, SolverStats& stats);
+    };
+}
+
+#endif
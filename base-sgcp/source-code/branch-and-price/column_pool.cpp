@@ -0,0 +1,78 @@
+#include "column_pool.hpp"
+
+namespace sgcp {
+    ColumnPool::ColumnPool(const ColumnPool& other) {
+        std::shared_lock<std::shared_mutex> lock{other.mutex};
+        columns = other.columns;
+        index = other.index;
+    }
+
+    ColumnPool::ColumnPool(ColumnPool&& other) {
+        std::unique_lock<std::shared_mutex> lock{other.mutex};
+        columns = std::move(other.columns);
+        index = std::move(other.index);
+    }
+
+    ColumnPool& ColumnPool::operator=(const ColumnPool& other) {
+        if(this == &other) { return *this; }
+
+        std::unique_lock<std::shared_mutex> lock{mutex, std::defer_lock};
+        std::shared_lock<std::shared_mutex> other_lock{other.mutex, std::defer_lock};
+        std::lock(lock, other_lock);
+
+        columns = other.columns;
+        index = other.index;
+
+        return *this;
+    }
+
+    ColumnPool& ColumnPool::operator=(ColumnPool&& other) {
+        if(this == &other) { return *this; }
+
+        std::unique_lock<std::shared_mutex> lock{mutex, std::defer_lock};
+        std::unique_lock<std::shared_mutex> other_lock{other.mutex, std::defer_lock};
+        std::lock(lock, other_lock);
+
+        columns = std::move(other.columns);
+        index = std::move(other.index);
+
+        return *this;
+    }
+
+    ColumnPool::ColumnPool(const StableSetCollection& sets) {
+        reserve(sets.size());
+        insert(sets);
+    }
+
+    std::pair<uint32_t, bool> ColumnPool::insert(const StableSet& s) {
+        std::unique_lock<std::shared_mutex> lock{mutex};
+
+        if(auto id = find_locked(s)) { return std::make_pair(*id, false); }
+
+        uint32_t id = columns.size();
+        columns.push_back(s);
+        index.emplace(s.hash(), id);
+
+        return std::make_pair(id, true);
+    }
+
+    boost::optional<uint32_t> ColumnPool::find(const StableSet& s) const {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return find_locked(s);
+    }
+
+    boost::optional<uint32_t> ColumnPool::find_locked(const StableSet& s) const {
+        auto range = index.equal_range(s.hash());
+
+        for(auto it = range.first; it != range.second; ++it) {
+            if(columns[it->second] == s) { return it->second; }
+        }
+
+        return boost::none;
+    }
+
+    StableSetCollection ColumnPool::get_columns() const {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return StableSetCollection(columns.begin(), columns.end());
+    }
+}
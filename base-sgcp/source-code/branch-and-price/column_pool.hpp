@@ -3,8 +3,73 @@
 
 #include "../stable_set.hpp"
 
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <boost/optional.hpp>
+
 namespace sgcp {
-    using ColumnPool = StableSetCollection;
+    // Global pool of the columns generated during branch-and-price.
+    // A column's id is its position in the pool, and it never changes since
+    // columns are never removed. Columns are kept in a deque, so references to
+    // them stay valid when new columns are added, and indexed by the hash of
+    // their vertex set, so that duplicates can be detected without scanning
+    // the whole pool.
+    // Lookups and insertions can be made concurrently from multiple threads
+    // (insertions take an exclusive lock, everything else a shared one), but
+    // iterating over the pool is only safe while no other thread inserts.
+    class ColumnPool {
+        std::deque<StableSet> columns;
+
+        // Maps the hash of a column to the ids of the columns with that hash.
+        std::unordered_multimap<std::size_t, uint32_t> index;
+
+        mutable std::shared_mutex mutex;
+
+        // Same as find, but the caller must hold a lock.
+        boost::optional<uint32_t> find_locked(const StableSet& s) const;
+
+    public:
+        using const_iterator = std::deque<StableSet>::const_iterator;
+
+        ColumnPool() = default;
+        ColumnPool(const ColumnPool& other);
+        ColumnPool(ColumnPool&& other);
+        ColumnPool& operator=(const ColumnPool& other);
+        ColumnPool& operator=(ColumnPool&& other);
+
+        // Creates a pool out of the (unique) stable sets of a collection.
+        explicit ColumnPool(const StableSetCollection& sets);
+
+        // Adds a column to the pool, unless an equal one is already there.
+        // Returns the id of the column in the pool and whether it was added.
+        std::pair<uint32_t, bool> insert(const StableSet& s);
+
+        // Adds all (unique) columns of a collection to the pool.
+        void insert(const StableSetCollection& sets) { for(const auto& s : sets) { insert(s); } }
+
+        // Gives the id of the column equal to s, if it is in the pool.
+        boost::optional<uint32_t> find(const StableSet& s) const;
+
+        // Tells whether a column equal to s is in the pool.
+        bool contains(const StableSet& s) const { return static_cast<bool>(find(s)); }
+
+        // Preallocates space for n columns.
+        void reserve(uint32_t n) { std::unique_lock<std::shared_mutex> lock{mutex}; index.reserve(n); }
+
+        const StableSet& at(uint32_t id) const { std::shared_lock<std::shared_mutex> lock{mutex}; return columns.at(id); }
+        const StableSet& operator[](uint32_t id) const { std::shared_lock<std::shared_mutex> lock{mutex}; return columns[id]; }
+
+        // Returns a copy of all the columns, in order of id.
+        StableSetCollection get_columns() const;
+
+        uint32_t size() const { std::shared_lock<std::shared_mutex> lock{mutex}; return columns.size(); }
+        bool empty() const { return size() == 0u; }
+        const_iterator begin() const { return columns.begin(); }
+        const_iterator end() const { return columns.end(); }
+    };
 }
 
-#endif
\ No newline at end of file
+#endif
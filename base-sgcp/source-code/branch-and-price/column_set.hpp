@@ -0,0 +1,53 @@
+#ifndef _COLUMN_SET_HPP
+#define _COLUMN_SET_HPP
+
+#include <memory>
+#include <algorithm>
+#include <boost/dynamic_bitset.hpp>
+
+namespace sgcp {
+    // Set of column ids, stored as a bitset indexed by column id, which grows
+    // together with the column pool. Copies share the same bitset until one of
+    // them is modified (copy-on-write), so that sets can be passed around for
+    // free when they do not change. An empty set allocates nothing.
+    class ColumnSet {
+        std::shared_ptr<boost::dynamic_bitset<>> bits;
+
+        // Makes sure this copy is the only owner of the bitset, before modifying it.
+        void detach() {
+            if(!bits) { bits = std::make_shared<boost::dynamic_bitset<>>(); }
+            else if(bits.use_count() > 1) { bits = std::make_shared<boost::dynamic_bitset<>>(*bits); }
+        }
+
+    public:
+        ColumnSet() = default;
+
+        // Tells whether the column with the given id is in the set.
+        bool contains(uint32_t cid) const { return bits && cid < bits->size() && bits->test(cid); }
+
+        // Adds the column with the given id to the set.
+        void insert(uint32_t cid) {
+            if(contains(cid)) { return; }
+
+            detach();
+            if(cid >= bits->size()) { bits->resize(std::max<std::size_t>(cid + 1u, 2u * bits->size())); }
+            bits->set(cid);
+        }
+
+        // Number of columns in the set.
+        uint32_t size() const { return bits ? bits->count() : 0u; }
+
+        bool empty() const { return !bits || bits->none(); }
+
+        // Calls f(cid) for each column id in the set, in increasing order.
+        template<typename F>
+        void for_each(F&& f) const {
+            if(!bits) { return; }
+            for(auto cid = bits->find_first(); cid != boost::dynamic_bitset<>::npos; cid = bits->find_next(cid)) {
+                f(static_cast<uint32_t>(cid));
+            }
+        }
+    };
+}
+
+#endif
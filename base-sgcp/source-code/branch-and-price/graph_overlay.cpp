@@ -0,0 +1,124 @@
+#include "graph_overlay.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace sgcp {
+    GraphOverlay::GraphOverlay(std::shared_ptr<const Graph> o) :
+        o{o}, removed{o->n_vertices}, representative(o->n_vertices), class_size(o->n_vertices, 1u), modified{false}
+    {
+        std::iota(representative.begin(), representative.end(), 0u);
+    }
+
+    void GraphOverlay::merge(uint32_t i, uint32_t j) {
+        auto ri = representative[i];
+        auto rj = representative[j];
+
+        if(ri == rj) { return; }
+        if(rj < ri) { std::swap(ri, rj); }
+
+        for(auto& r : representative) { if(r == rj) { r = ri; } }
+        class_size[ri] += class_size[rj];
+        modified = true;
+    }
+
+    bool GraphOverlay::is_compatible(const StableSet& s) const {
+        // Dummy column always compatible
+        if(s.dummy) { return true; }
+
+        const auto& set = s.get_set();
+
+        if(std::any_of(set.begin(), set.end(), [&] (uint32_t id) { return removed.test(id); })) { return false; }
+
+        std::vector<uint32_t> reps;
+        reps.reserve(set.size());
+        for(auto id : set) { reps.push_back(representative[id]); }
+        std::sort(reps.begin(), reps.end());
+
+        // Each class must be covered entirely, or not at all.
+        for(auto it = reps.begin(); it != reps.end();) {
+            auto next = std::upper_bound(it, reps.end(), *it);
+            if(static_cast<uint32_t>(std::distance(it, next)) != class_size[*it]) { return false; }
+            it = next;
+        }
+
+        return std::none_of(links.begin(), links.end(), [&] (const auto& link) {
+            return  std::binary_search(reps.begin(), reps.end(), representative[link.first]) &&
+                    std::binary_search(reps.begin(), reps.end(), representative[link.second]);
+        });
+    }
+
+    std::shared_ptr<const Graph> GraphOverlay::materialise() const {
+        if(!modified) { return o; }
+
+        // Original ids coincide with the ids of the original graph, which are 0, ..., n - 1.
+        const auto n = o->n_vertices;
+
+        std::vector<uint32_t> new_id(n, Partition::none);
+        std::vector<std::vector<uint32_t>> represented;
+
+        for(auto i = 0u; i < n; ++i) {
+            if(removed.test(i)) { continue; }
+
+            auto r = representative[i];
+            if(new_id[r] == Partition::none) {
+                new_id[r] = represented.size();
+                represented.emplace_back();
+            }
+            new_id[i] = new_id[r];
+            represented[new_id[i]].push_back(i);
+        }
+
+        const auto n_new = static_cast<uint32_t>(represented.size());
+
+        BoostGraph new_bg;
+        for(auto v = 0u; v < n_new; ++v) {
+            auto new_v = add_vertex(new_bg);
+            new_bg[new_v] = VertexInfo{v, std::move(represented[v])};
+        }
+
+        // With vecS, the descriptor of each new vertex is its id. The matrix
+        // avoids parallel edges between classes of merged vertices.
+        AdjacencyMatrix new_adj(n_new);
+        auto add = [&] (uint32_t i, uint32_t j) {
+            auto a = new_id[i], b = new_id[j];
+            if(a != b && !new_adj.connected(a, b)) {
+                new_adj.add_edge(a, b);
+                add_edge(a, b, new_bg);
+            }
+        };
+
+        for(auto i = 0u; i < n; ++i) {
+            if(removed.test(i)) { continue; }
+
+            const auto* row = o->adj.row(i);
+            for(auto w = i / Bitset::word_bits; w < o->adj.n_words(); ++w) {
+                for(Bitset::Word word = row[w]; word != 0u; word &= word - 1u) {
+                    auto j = w * Bitset::word_bits + static_cast<uint32_t>(__builtin_ctzll(word));
+                    if(j > i && !removed.test(j)) { add(i, j); }
+                }
+            }
+        }
+
+        // Vertices linked by a decision can be removed by a later one.
+        for(const auto& link : links) {
+            if(!removed.test(link.first) && !removed.test(link.second)) { add(link.first, link.second); }
+        }
+
+        Partition new_p;
+        new_p.reserve(o->n_partitions, n);
+        std::vector<uint32_t> set;
+
+        for(auto k = 0u; k < o->n_partitions; ++k) {
+            set.clear();
+            for(auto id : o->p[k]) {
+                if(!removed.test(id)) { set.push_back(new_id[id]); }
+            }
+            std::sort(set.begin(), set.end());
+            set.erase(std::unique(set.begin(), set.end()), set.end());
+            new_p.push_back(set);
+        }
+
+        return std::make_shared<const Graph>(new_bg, new_p, o->params);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef _GRAPH_OVERLAY_HPP
+#define _GRAPH_OVERLAY_HPP
+
+#include "../graph.hpp"
+#include "../stable_set.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sgcp {
+    // Branching decisions taken on the path from the root to a B&B node, stored as
+    // a delta over the original graph: a mask of the removed vertices, the classes
+    // of merged vertices and the edges added between classes. All vertex ids are
+    // original ids. The overlay is cheap to build and to query, and the node's local
+    // graph is only materialised from it when the node is solved.
+    class GraphOverlay {
+        std::shared_ptr<const Graph> o;
+
+        Bitset removed;
+
+        // Smallest id of each vertex's class of merged vertices, and size of each class
+        // (indexed by the smallest id). Classes are kept flat, so lookups take constant time.
+        std::vector<uint32_t> representative;
+        std::vector<uint32_t> class_size;
+
+        // Added edges, each given by one vertex of the two classes it links.
+        std::vector<std::pair<uint32_t, uint32_t>> links;
+
+        bool modified;
+
+    public:
+        explicit GraphOverlay(std::shared_ptr<const Graph> o);
+
+        void remove(uint32_t id) { removed.set(id); modified = true; }
+        void link(uint32_t i, uint32_t j) { links.emplace_back(i, j); modified = true; }
+        void merge(uint32_t i, uint32_t j);
+
+        bool is_removed(uint32_t id) const { return removed.test(id); }
+        uint32_t representative_of(uint32_t id) const { return representative[id]; }
+
+        // Tells whether a stable set of the original graph is still a stable set once
+        // the decisions are applied, i.e. it contains no removed vertex, it contains
+        // either all or none of the vertices of each class, and no added edge links
+        // two of its vertices.
+        bool is_compatible(const StableSet& s) const;
+
+        // Builds the graph obtained applying the decisions to the original graph.
+        // Each class of merged vertices becomes one vertex, with the union of their
+        // neighbourhoods; vertices get ids in order of their smallest original id.
+        std::shared_ptr<const Graph> materialise() const;
+    };
+}
+
+#endif
@@ -41,19 +41,11 @@ namespace sgcp {
                 // Not interested in re-inserting the same vertex we just removed!
                 if(w == v) { continue; }
 
-                if(std::any_of(
-                    rem_set.get_set().begin(),
-                    rem_set.get_set().end(),
-                    [&] (uint32_t vremaining) -> bool {
-                        // The partition of w is already coloured by this colour, not intersted!
-                        if(g.partition_for(w) == g.partition_for(vremaining)) { return true; }
+                // The partition of w is already coloured by this colour, not intersted!
+                if(rem_set.intersects(g.partition_for(w))) { continue; }
 
-                        // Vertices linked by an edge: cannot colour together!
-                        if(g.connected(w, vremaining)) { return true; }
-
-                        return false;
-                    }
-                )) { continue; }
+                // Vertices linked by an edge: cannot colour together!
+                if(g.adjacent_to_any(w, rem_set.get_vertices())) { continue; }
 
                 rem_set.add_vertex(w);
                 assert(rem_set.is_valid(true));
@@ -61,9 +53,7 @@ namespace sgcp {
                 added_stg = true;
             }
 
-            if(added_stg && std::find(new_cols.begin(), new_cols.end(), rem_set) == new_cols.end()) {
-                new_cols.push_back(rem_set);
-            }
+            if(added_stg) { new_cols.insert(rem_set); }
         }
     }
 }
\ No newline at end of file
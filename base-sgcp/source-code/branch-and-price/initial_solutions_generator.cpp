@@ -8,12 +8,12 @@
 #include <thread>
 
 namespace sgcp {
-    InitialSolution InitialSolutionsGenerator::generate_from_existing(ColumnPool& start_solution) {
+    InitialSolution InitialSolutionsGenerator::generate_from_existing(StableSetCollection& start_solution) {
         using namespace std::chrono;
 
         assert(std::all_of(start_solution.begin(), start_solution.end(), [] (const auto& ss) { return ss.is_valid(false); }));
 
-        ColumnPool alns_wa_columns, alns_nd_columns, tabu_columns;
+        StableSetCollection alns_wa_columns, alns_nd_columns, tabu_columns;
         std::thread alns_wa, alns_nd, tabu;
 
         tabu = std::thread(
@@ -65,24 +65,19 @@ namespace sgcp {
         ColumnPool initial_columns;
         std::vector<uint32_t> best_id;
 
+        // The best solution goes in first, and we keep track of its columns' ids.
         if(tabu_columns.size() == best_sol_size) {
-            best_id = std::vector<uint32_t>(tabu_columns.size());
-            std::iota(best_id.begin(), best_id.end(), 0u);
-            initial_columns = tabu_columns;
+            best_id = add_unique(initial_columns, tabu_columns);
             add_unique(initial_columns, start_solution);
             add_unique(initial_columns, alns_wa_columns);
             add_unique(initial_columns, alns_nd_columns);
         } else if(alns_wa_columns.size() == best_sol_size) {
-            best_id = std::vector<uint32_t>(alns_wa_columns.size());
-            std::iota(best_id.begin(), best_id.end(), 0u);
-            initial_columns = alns_wa_columns;
+            best_id = add_unique(initial_columns, alns_wa_columns);
             add_unique(initial_columns, start_solution);
             add_unique(initial_columns, tabu_columns);
             add_unique(initial_columns, alns_nd_columns);
         } else if(alns_nd_columns.size() == best_sol_size) {
-            best_id = std::vector<uint32_t>(alns_nd_columns.size());
-            std::iota(best_id.begin(), best_id.end(), 0u);
-            initial_columns = alns_nd_columns;
+            best_id = add_unique(initial_columns, alns_nd_columns);
             add_unique(initial_columns, start_solution);
             add_unique(initial_columns, tabu_columns);
             add_unique(initial_columns, alns_wa_columns);
@@ -104,10 +99,12 @@ namespace sgcp {
         return generate_from_existing(start_solution);
     }
 
-    void InitialSolutionsGenerator::add_unique(ColumnPool& pool, const ColumnPool& add) const {
-        for(const auto& newcol : add) {
-            auto it = std::find(pool.begin(), pool.end(), newcol);
-            if(it == pool.end()) { pool.push_back(newcol); }
-        }
+    std::vector<uint32_t> InitialSolutionsGenerator::add_unique(ColumnPool& pool, const StableSetCollection& add) const {
+        std::vector<uint32_t> ids;
+        ids.reserve(add.size());
+
+        for(const auto& newcol : add) { ids.push_back(pool.insert(newcol).first); }
+
+        return ids;
     }
 }
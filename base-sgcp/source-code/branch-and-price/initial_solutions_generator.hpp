@@ -16,12 +16,14 @@ namespace sgcp {
         const Graph& g;
         SolverStats& stats;
 
-        void add_unique(ColumnPool& pool, const ColumnPool& add) const;
+        // Adds the columns which are not already in the pool, and returns
+        // the ids in the pool of all the columns in add.
+        std::vector<uint32_t> add_unique(ColumnPool& pool, const StableSetCollection& add) const;
 
     public:
         InitialSolutionsGenerator(const Graph& g, SolverStats& stats) : g{g}, stats{stats} {}
 
-        InitialSolution generate_from_existing(ColumnPool& start_solution);
+        InitialSolution generate_from_existing(StableSetCollection& start_solution);
         InitialSolution generate();
     };
 }
@@ -13,10 +13,10 @@ namespace sgcp {
         
         for(const auto& col : columns) {
             if(col.second > eps) {
-                auto it = std::find(c.begin(), c.end(), col.first);
-                assert(it != c.end());
+                auto id = c.find(col.first);
+                assert(id);
                 
-                ac[std::distance(c.begin(), it)] = col.second;
+                ac[*id] = col.second;
             }
         }
         
@@ -23,24 +23,7 @@ namespace sgcp {
             name.str("");name.clear();
         }
 
-        for(auto cid = 0u; cid < c.size(); cid++) {
-            // Give a high price to the dummy column. For example,
-            // 2 * number of vertices is more costly than any other
-            // feasible solution (which uses at most 1 colour for
-            // each partition).
-            auto col_price = c.at(cid).dummy ? (2 * g.n_vertices) : 1;
-            IloNumColumn col = obj(col_price);
-
-            for(auto k = 0u; k < g.n_partitions; ++k) {
-                if(c.at(cid).intersects(k)) {
-                    col += colour[k](1);
-                }
-            }
-
-            name << "x_" << cid;
-            x.add(IloNumVar(col, 0, (lp ? IloInfinity : 1), (lp ? IloNumVar::Float : IloNumVar::Bool), name.str().c_str()));
-            name.str(""); name.clear();
-        }
+        add_columns(0u, c.size());
 
         model.add(x);
         model.add(colour);
@@ -64,7 +47,8 @@ namespace sgcp {
         std::map<StableSet, float> columns;
         std::vector<float> duals(g.n_partitions, 0.0);
 
-        for(auto cid = 0u; cid < c.size(); cid++) {
+        // Only the columns in the model: the pool might have grown since it was solved.
+        for(auto cid = 0u; cid < static_cast<uint32_t>(x.getSize()); cid++) {
             auto val = cplex.getValue(x[cid]);
             if(val > static_cast<double>(eps)) { columns[c.at(cid)] = val; }
         }
@@ -79,6 +63,8 @@ namespace sgcp {
             throw std::runtime_error("Can't add a mipstart to an LP!");
         }
 
+        sync_columns(c.size());
+
         IloNumVarArray initial_vars(env);
         IloNumArray initial_vals(env);
 
@@ -98,14 +84,32 @@ namespace sgcp {
         initial_vals.end();
     }
 
-    boost::optional<MpSolution> MpSolver::solve(const std::vector<uint32_t>& forbidden_columns, bool skip_forbidden_columns_check, bool first_node_tilim) const {
-        if(!skip_forbidden_columns_check) {
-            for(auto cid = 0u; cid < c.size(); cid++) {
-                if(std::find(forbidden_columns.begin(), forbidden_columns.end(), cid) == forbidden_columns.end()) {
-                    if(lp) { x[cid].setUB(IloInfinity); } else { x[cid].setUB(1); }
-                } else { x[cid].setUB(0); }
-            }
-        }
+    void MpSolver::update_bounds(const ColumnSet& forbidden_columns) const {
+        IloNumVarArray vars(env);
+        IloNumArray lbs(env), ubs(env);
+
+        // Only collect the bounds which differ from the ones currently in the model.
+        forbidden_columns.for_each([&] (uint32_t cid) {
+            if(!model_forbidden_columns.contains(cid)) { vars.add(x[cid]); lbs.add(0); ubs.add(0); }
+        });
+        model_forbidden_columns.for_each([&] (uint32_t cid) {
+            if(!forbidden_columns.contains(cid)) { vars.add(x[cid]); lbs.add(0); ubs.add(lp ? IloInfinity : 1); }
+        });
+
+        // Push them to CPLEX all at once.
+        if(vars.getSize() > 0) { vars.setBounds(lbs, ubs); }
+
+        vars.end();
+        lbs.end();
+        ubs.end();
+
+        model_forbidden_columns = forbidden_columns;
+    }
+
+    boost::optional<MpSolution> MpSolver::solve(const ColumnSet& forbidden_columns, uint32_t n_columns, bool skip_forbidden_columns_check, bool first_node_tilim) const {
+        sync_columns(n_columns);
+
+        if(!skip_forbidden_columns_check) { update_bounds(forbidden_columns); }
 
         auto old_tilim = cplex.getParam(IloCplex::TiLim);
         if(first_node_tilim) { cplex.setParam(IloCplex::TiLim, g.params.mip_heur_time_limit_first); }
@@ -142,34 +146,47 @@ namespace sgcp {
         }
     }
 
-    void MpSolver::add_column(const StableSet& col) {
-        std::stringstream name("");
+    void MpSolver::add_columns(uint32_t first_id, uint32_t last_id) const {
+        IloNumVarArray new_x(env);
+        std::stringstream name;
+
+        assert(first_id == static_cast<uint32_t>(x.getSize()));
 
-        // Give a high price to the dummy column. For example,
-        // 2 * number of vertices is more costly than any other
-        // feasible solution (which uses at most 1 colour for
-        // each partition).
-        auto col_price = col.dummy ? (2 * g.n_vertices) : 1;
+        for(auto cid = first_id; cid < last_id; ++cid) {
+            const auto& s = c.at(cid);
+
+            // Give a high price to the dummy column. For example,
+            // 2 * number of vertices is more costly than any other
+            // feasible solution (which uses at most 1 colour for
+            // each partition).
+            auto col_price = s.dummy ? (2 * g.n_vertices) : 1;
+            IloNumColumn col = obj(col_price);
 
-        IloNumColumn cpxcol = obj(col_price);
+            // Only the partitions covered by the column have a non-zero coefficient.
+            s.get_partitions().for_each([&] (uint32_t k) { col += colour[k](1); });
 
-        for(auto k = 0u; k < g.n_partitions; ++k) {
-            if(col.intersects(k)) { cpxcol += colour[k](1); }
+            name << "x_" << cid;
+            new_x.add(IloNumVar(col, 0, (lp ? IloInfinity : 1), (lp ? IloNumVar::Float : IloNumVar::Bool), name.str().c_str()));
+            name.str(""); name.clear();
         }
 
-        name << "x_" << x.getSize();
-        x.add(IloNumVar(cpxcol, 0, (lp ? IloInfinity : 1), (lp ? IloNumVar::Float : IloNumVar::Bool), name.str().c_str()));
+        x.add(new_x);
+        new_x.end();
+    }
+
+    void MpSolver::sync_columns(uint32_t n_columns) const {
+        if(static_cast<uint32_t>(x.getSize()) < n_columns) { add_columns(x.getSize(), n_columns); }
     }
 
-    boost::optional<MpSolution> MpSolver::solve_with_forbidden_check(const std::vector<uint32_t>& forbidden_columns) const {
-        return solve(forbidden_columns, false, false);
+    boost::optional<MpSolution> MpSolver::solve_with_forbidden_check(const ColumnSet& forbidden_columns, boost::optional<uint32_t> n_columns) const {
+        return solve(forbidden_columns, n_columns ? *n_columns : c.size(), false, false);
     }
 
-    boost::optional<MpSolution> MpSolver::solve_without_forbidden_check(const std::vector<uint32_t>& forbidden_columns) const {
-        return solve(forbidden_columns, true, false);
+    boost::optional<MpSolution> MpSolver::solve_without_forbidden_check(const ColumnSet& forbidden_columns) const {
+        return solve(forbidden_columns, c.size(), true, false);
     }
 
-    boost::optional<MpSolution> MpSolver::solve_with_first_node_tilim(const std::vector<uint32_t>& forbidden_columns) const {
-        return solve(forbidden_columns, true, true);
+    boost::optional<MpSolution> MpSolver::solve_with_first_node_tilim(const ColumnSet& forbidden_columns) const {
+        return solve(forbidden_columns, c.size(), true, true);
     }
 }
@@ -5,6 +5,7 @@
 #include "../stable_set.hpp"
 #include "mp_solution.hpp"
 #include "column_pool.hpp"
+#include "column_set.hpp"
 
 #include <vector>
 #include <boost/optional.hpp>
@@ -29,24 +30,43 @@ namespace sgcp {
         mutable IloRangeArray colour;
         mutable IloObjective obj;
         
+        // Columns whose upper bound is currently set to zero in the model.
+        mutable ColumnSet model_forbidden_columns;
+
         bool lp;
 
         static constexpr float eps = 1e-6;
 
         MpSolution make_solution() const;
         void create_model() const;
+
+        // Sets to zero the upper bound of the forbidden columns and restores the one of
+        // the columns which are no longer forbidden, in a single batch. Columns whose
+        // status did not change since the last call are not touched.
+        void update_bounds(const ColumnSet& forbidden_columns) const;
+
+        // Adds the columns of the pool with ids in [first_id, last_id) to the model, in a
+        // single batch. They must be the ones which come right after those already in the model.
+        void add_columns(uint32_t first_id, uint32_t last_id) const;
+
+        // Adds to the model the columns of the pool with id lower than n_columns which
+        // are not there yet.
+        void sync_columns(uint32_t n_columns) const;
         
-        boost::optional<MpSolution> solve(const std::vector<uint32_t>& forbidden_columns, bool skip_forbidden_columns_check, bool first_node_tilim) const;
+        boost::optional<MpSolution> solve(const ColumnSet& forbidden_columns, uint32_t n_columns, bool skip_forbidden_columns_check, bool first_node_tilim) const;
 
     public:
         MpSolver(const Graph& g, const ColumnPool& c, bool lp) : g{g}, c{c}, lp{lp} { create_model(); }
         
         ~MpSolver() { env.end(); }
         
-        boost::optional<MpSolution> solve_with_forbidden_check(const std::vector<uint32_t>& forbidden_columns) const;
-        boost::optional<MpSolution> solve_without_forbidden_check(const std::vector<uint32_t>& forbidden_columns) const;
-        boost::optional<MpSolution> solve_with_first_node_tilim(const std::vector<uint32_t>& forbidden_columns) const;
-        void add_column(const StableSet& col);
+        // Columns which are in the pool but not in the model are added before each solve, so
+        // the solver does not need to be kept up to date as the pool grows. When other threads
+        // add columns to the pool, n_columns limits the ones used to those which have already
+        // been checked against forbidden_columns.
+        boost::optional<MpSolution> solve_with_forbidden_check(const ColumnSet& forbidden_columns, boost::optional<uint32_t> n_columns = boost::none) const;
+        boost::optional<MpSolution> solve_without_forbidden_check(const ColumnSet& forbidden_columns) const;
+        boost::optional<MpSolution> solve_with_first_node_tilim(const ColumnSet& forbidden_columns) const;
         void add_mipstart(const std::vector<uint32_t>& mipstart_columns) const;
     };
 }
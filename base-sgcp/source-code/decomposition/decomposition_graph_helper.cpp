@@ -4,7 +4,7 @@
 namespace sgcp {
     Graph DecompositionGraphHelper::make_subgraph(const std::set<uint32_t>& partitions) const {
         BoostGraph subg;
-        Partition subp(g.n_partitions);
+        Partition subp;
         std::map<uint32_t, uint32_t> id_shift;
         uint32_t subid = 0u;
 
@@ -29,27 +29,18 @@ namespace sgcp {
             auto kt = g.partition_for(t_id);
             if(partitions.find(kt) == partitions.end()) { continue; }
 
-            // Using make_optional because of a GCC -Wmaybe-uninitialized false positive:
-            // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=47679
-            auto s_subv = boost::make_optional(false, Vertex{});
-            auto t_subv = boost::make_optional(false, Vertex{});
-
-            for(auto svit = vertices(subg); svit.first != svit.second; ++svit.first) {
-                if(!s_subv && subg[*svit.first].id == id_shift[s_id]) { s_subv = *svit.first; if(t_subv) { break; } }
-                if(!t_subv && subg[*svit.first].id == id_shift[t_id]) { t_subv = *svit.first; if(s_subv) { break; } }
-            }
-            assert(s_subv && t_subv);
-
-            add_edge(*s_subv, *t_subv, subg);
+            // Sub-vertices are added in id order, so their descriptor is their id.
+            add_edge(vertex(id_shift[s_id], subg), vertex(id_shift[t_id], subg), subg);
         }
 
         for(auto k = 0u; k < g.n_partitions; k++) {
-            subp[k] = std::unordered_set<uint32_t>();
+            std::vector<uint32_t> subset;
             if(partitions.find(k) != partitions.end()) {
                 for(auto v_id : g.p[k]) {
-                    subp[k].insert(id_shift[v_id]);
+                    subset.push_back(id_shift[v_id]);
                 }
             }
+            subp.push_back(subset);
         }
 
         return Graph{subg, subp, g.params};
@@ -106,17 +97,11 @@ namespace sgcp {
     }
 
     bool DecompositionGraphHelper::independent(const Graph& subgraph, uint32_t v_id, const std::vector<uint32_t>& other_v) const {
-        auto v = subgraph.vertex_by_id(v_id);
-        assert(v);
-
-        for(auto w_id : other_v) {
-            auto w = subgraph.vertex_by_id(w_id);
-            assert(w);
-
-            if(edge(*v, *w, subgraph.g).second) { return false; }
-        }
-
-        return true;
+        return std::none_of(
+            other_v.begin(),
+            other_v.end(),
+            [&] (uint32_t w_id) { return subgraph.connected(v_id, w_id); }
+        );
     }
 
     bool DecompositionGraphHelper::heuristic_stable_set_covers_all_partitions(const Graph& subg, const PartitionsIdSet& partitions) const {
@@ -125,9 +110,10 @@ namespace sgcp {
 
         for(auto i = 0u; i < subg.n_vertices; i++) { wm[i] = 1; }
 
+        auto solv = SewellMwssSolver{g, subg};
+
         while(iter < 10) {
-            auto solv = SewellMwssSolver(g, subg, wm);
-            auto sset = solv.solve();
+            auto sset = solv.solve(wm);
 
             if(!sset) { return false; }
 
@@ -157,7 +143,7 @@ namespace sgcp {
             
             for(auto it = out_edges(*v, g.g); it.first != it.second; ++it.first) {
                 auto w_id = g.g[target(*it.first, g.g)].id;
-                if(std::find(g.p[k].begin(), g.p[k].end(), w_id) == g.p[k].end()) { connected_vertices.insert(w_id); }
+                if(g.partition_for(w_id) != k) { connected_vertices.insert(w_id); }
             }
         }        
         return connected_vertices.size();
@@ -14,14 +14,8 @@ namespace sgcp {
                 bool in_clique = true;
 
                 for(auto v1_id : g.p[k1]) {
-                    auto v1 = g.vertex_by_id(v1_id);
-                    assert(v1);
-
                     for(auto v2_id : g.p[k2]) {
-                        auto v2 = g.vertex_by_id(v2_id);
-                        assert(v2);
-
-                        if(!edge(*v1, *v2, g.g).second) {
+                        if(!g.connected(v1_id, v2_id)) {
                             in_clique = false;
                             break;
                         }
@@ -28,7 +28,7 @@ namespace sgcp {
         InitialSolutionsGenerator is{g, stats};
 
         auto columns = is.generate();
-        auto fcolumns = std::vector<uint32_t>{};
+        auto fcolumns = ColumnSet{};
         MpSolver mp{g, columns.columns, false};
         mp.add_mipstart(columns.feasible_solution_ids);
         auto initial_solution = mp.solve_without_forbidden_check(fcolumns);
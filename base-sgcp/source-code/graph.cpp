@@ -2,12 +2,58 @@
 
 #include "utils/console_colour.hpp"
 #include "utils/dbg_output.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/text_scanner.hpp"
 
-#include <iostream>
+#include "utils/binary_io.hpp"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <functional>
 
 namespace sgcp {
+    namespace {
+        // Binary file of a preprocessed instance: the header below, followed by
+        // arrays of uint32_t: the edges (source and target id of each, in the
+        // order of edges(g)), the partition offsets and elements (as in
+        // Partition) and the input ids of the vertices.
+        constexpr char binary_magic[8] = {'S', 'G', 'C', 'P', 'B', 'I', 'N', '1'};
+
+        // To be increased whenever preprocessing changes, so that the binary
+        // files it produced are no longer used.
+        constexpr uint32_t preprocessing_version = 2u;
+
+        struct BinaryHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t n_vertices;
+            uint64_t source_size;
+            int64_t source_mtime;
+            uint32_t n_edges;
+            uint32_t n_partitions;
+            uint32_t n_elements;
+            uint32_t reserved;
+        };
+
+        // Size and modification time (in ns) of the instance file, which identify the
+        // version of the file a binary was written from.
+        struct Fingerprint {
+            uint64_t size;
+            int64_t mtime;
+        };
+
+        boost::optional<Fingerprint> fingerprint_of(const std::string& filename) {
+            struct stat st;
+            if(filename.empty() || ::stat(filename.c_str(), &st) != 0) { return boost::none; }
+            return Fingerprint{static_cast<uint64_t>(st.st_size), int64_t{st.st_mtim.tv_sec} * 1000000000 + st.st_mtim.tv_nsec};
+        }
+    }
+
     std::ostream& operator<<(std::ostream& out, const VertexInfo& v) {
         using namespace Console;
 
@@ -50,69 +96,106 @@ namespace sgcp {
         n_edges = num_edges(g);
         n_partitions = p.size();
         data_filename = "";
+
+        index_vertices();
+        build_adjacency_matrix();
     }
 
     Graph::Graph(std::string filename, std::string params_filename) : params{params_filename}, data_filename{filename} {
+        if(!read_binary(binary_filename_for(filename))) {
+            read_text(filename);
+            build_adjacency_matrix();
+        }
+    }
+
+    void Graph::read_text(const std::string& filename) {
         DEBUG_ONLY(using namespace Console;)
-        std::ifstream gfile(filename, std::ios_base::in);
+        MappedFile gfile{filename};
+
+        if(gfile.empty()) { throw std::runtime_error("Cannot read graph file: " + filename); }
 
         DEBUG_ONLY(std::cout << colour_magenta("Reading graph in ") << colour_magenta(filename) << std::endl;)
 
-        gfile >> n_vertices;
-        gfile >> n_edges;
-        gfile >> n_partitions;
+        TextScanner scanner{gfile.data(), gfile.data() + gfile.size()};
+
+        auto read_uint = [&] (const char* what) -> uint32_t {
+            auto n = scanner.next_uint();
+            if(!n) { throw std::runtime_error(std::string{"Cannot read "} + what + " from " + filename); }
+            return *n;
+        };
+
+        n_vertices = read_uint("the number of vertices");
+        n_edges = read_uint("the number of edges");
+        n_partitions = read_uint("the number of partitions");
 
-        assert(n_vertices > 0u);
-        assert(n_partitions > 0u);
+        if(n_vertices == 0u || n_partitions == 0u) { throw std::runtime_error("Empty graph in " + filename); }
 
         DEBUG_ONLY(std::cout << "\t" << colour_magenta(n_vertices) << " vertices" << std::endl;)
         DEBUG_ONLY(std::cout << "\t" << colour_magenta(n_edges) << " edges" << std::endl;)
         DEBUG_ONLY(std::cout << "\t" << colour_magenta(n_partitions) << " partitions" << std::endl;)
 
-        for(uint32_t i = 0u; i < n_vertices; i++) {
-            auto v = add_vertex(g);
-            g[v] = VertexInfo{i, {i}};
-        }
+        std::vector<std::pair<uint32_t, uint32_t>> edge_list;
+        edge_list.reserve(n_edges);
 
         for(uint32_t n_line = 0u; n_line < n_edges; n_line++) {
-            uint32_t from, to;
+            auto from = read_uint("an edge");
+            auto to = read_uint("an edge");
 
-            gfile >> from >> to;
-            assert(from < n_vertices);
-            assert(to < n_vertices);
+            if(from >= n_vertices || to >= n_vertices) { throw std::runtime_error("Invalid edge in " + filename); }
 
-            auto from_v = vertex_by_id(from);
-            auto to_v = vertex_by_id(to);
-            assert(from_v);
-            assert(to_v);
-
-            add_edge(*from_v, *to_v, g);
+            edge_list.emplace_back(from, to);
         }
 
-        std::stringstream ss("");
-        std::string line;
+        std::vector<uint32_t> set;
 
-        gfile >> std::ws;
+        scanner.skip_whitespace();
 
-        for(uint32_t n_line = 0u; n_line < n_partitions; n_line++) {
-            std::getline(gfile, line);
-            ss.str(line);
+        p.reserve(n_partitions, n_vertices);
 
-            p.push_back(std::unordered_set<uint32_t>());
+        for(uint32_t n_line = 0u; n_line < n_partitions; n_line++) {
+            set.clear();
 
-            uint32_t element;
-            while(ss >> element) {
-                assert(element < n_vertices);
-                p.back().insert(element);
+            while(auto element = scanner.next_uint_in_line()) {
+                if(*element >= n_vertices) { throw std::runtime_error("Invalid vertex in a partition of " + filename); }
+                set.push_back(*element);
             }
 
-            ss.str(""); ss.clear();
+            p.push_back(set);
+
+            scanner.next_line();
+        }
+
+        // Size each out-edge list for the vertex's edges, plus the ones which
+        // make_partition_cliques may add, so that adding them never reallocates.
+        std::vector<uint32_t> max_degree(n_vertices, 0u);
+
+        for(const auto& e : edge_list) {
+            ++max_degree[e.first];
+            ++max_degree[e.second];
         }
 
+        for(auto k = 0u; k < p.size(); k++) {
+            for(auto i : p[k]) { max_degree[i] += p[k].size() - 1u; }
+        }
+
+        g = BoostGraph(n_vertices);
+
+        for(uint32_t i = 0u; i < n_vertices; i++) {
+            g[i] = VertexInfo{i, {i}};
+            g.out_edge_list(i).reserve(max_degree[i]);
+        }
+
+        for(const auto& e : edge_list) {
+            add_edge(e.first, e.second, g);
+        }
+
+        index_vertices();
+
         assert(num_vertices(g) == n_vertices);
         assert(num_edges(g) == n_edges);
         assert(p.size() == n_partitions);
 
+        build_adjacency_matrix();
         make_partition_cliques();
         do_preprocessing();
         renumber_vertices();
@@ -123,126 +206,274 @@ namespace sgcp {
         n_partitions = p.size();
     }
 
+    std::string Graph::binary_filename_for(const std::string& filename) {
+        auto ext = filename.find_last_of('.');
+        if(ext != std::string::npos && filename.compare(ext, std::string::npos, ".txt") == 0) {
+            return filename.substr(0, ext) + ".bin";
+        }
+        return filename + ".bin";
+    }
+
+    void Graph::write_binary(const std::string& bin_filename) const {
+        auto fp = fingerprint_of(data_filename);
+        if(!fp) { throw std::runtime_error("Cannot read graph file: " + data_filename); }
+
+        assert(input_ids.size() == n_vertices);
+
+        BinaryHeader h{};
+        std::memcpy(h.magic, binary_magic, sizeof(binary_magic));
+        h.version = preprocessing_version;
+        h.n_vertices = n_vertices;
+        h.source_size = fp->size;
+        h.source_mtime = fp->mtime;
+        h.n_edges = n_edges;
+        h.n_partitions = n_partitions;
+        h.n_elements = static_cast<uint32_t>(p.cluster_elements().size());
+
+        std::vector<uint32_t> edge_ids;
+        edge_ids.reserve(2u * n_edges);
+
+        for(auto it = edges(g); it.first != it.second; ++it.first) {
+            edge_ids.push_back(g[source(*it.first, g)].id);
+            edge_ids.push_back(g[target(*it.first, g)].id);
+        }
+
+        auto tmp_filename = bin_filename + ".tmp";
+        std::ofstream out(tmp_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        binary_io::write(out, h);
+        binary_io::write_array(out, edge_ids);
+        binary_io::write_array(out, p.cluster_offsets());
+        binary_io::write_array(out, p.cluster_elements());
+        binary_io::write_array(out, input_ids);
+
+        out.close();
+        if(!out) { throw std::runtime_error("Cannot write graph file: " + tmp_filename); }
+
+        if(std::rename(tmp_filename.c_str(), bin_filename.c_str()) != 0) {
+            throw std::runtime_error("Cannot rename graph file to: " + bin_filename);
+        }
+    }
+
+    bool Graph::read_binary(const std::string& bin_filename) {
+        DEBUG_ONLY(using namespace Console;)
+        MappedFile bfile{bin_filename};
+
+        if(bfile.size() < sizeof(BinaryHeader)) { return false; }
+
+        BinaryHeader h;
+        std::memcpy(&h, bfile.data(), sizeof(h));
+
+        if(std::memcmp(h.magic, binary_magic, sizeof(binary_magic)) != 0 || h.version != preprocessing_version) { return false; }
+
+        // A binary file older than the instance file is ignored.
+        auto fp = fingerprint_of(data_filename);
+        if(!fp || fp->size != h.source_size || fp->mtime != h.source_mtime) { return false; }
+
+        uint64_t n_words = 2u * uint64_t{h.n_edges} + h.n_partitions + 1u + h.n_elements + h.n_vertices;
+        if(bfile.size() != sizeof(BinaryHeader) + n_words * sizeof(uint32_t)) { return false; }
+
+        // The arrays are read straight from the mapped file, with no parsing. They are not used
+        // zero-copy: the partition and the input ids are bulk copies of them, and the graph and
+        // adjacency matrix are rebuilt from the edge array, one edge at a time.
+        const auto* edge_ids = reinterpret_cast<const uint32_t*>(bfile.data() + sizeof(BinaryHeader));
+        const auto* offsets = edge_ids + 2u * h.n_edges;
+        const auto* elements = offsets + h.n_partitions + 1u;
+        const auto* ids = elements + h.n_elements;
+
+        if(offsets[0] != 0u || offsets[h.n_partitions] != h.n_elements || !std::is_sorted(offsets, offsets + h.n_partitions + 1u)) { return false; }
+        if(std::any_of(elements, elements + h.n_elements, [&] (uint32_t i) { return i >= h.n_vertices; })) { return false; }
+
+        DEBUG_ONLY(std::cout << colour_magenta("Reading preprocessed graph in ") << colour_magenta(bin_filename) << std::endl;)
+
+        std::vector<uint32_t> degree(h.n_vertices, 0u);
+
+        for(auto e = 0u; e < 2u * h.n_edges; e++) {
+            if(edge_ids[e] >= h.n_vertices) { return false; }
+            ++degree[edge_ids[e]];
+        }
+
+        n_vertices = h.n_vertices;
+        n_edges = h.n_edges;
+        n_partitions = h.n_partitions;
+
+        // Edges are added in the order they were saved, which is the order of
+        // the graph they were saved from, both in edges() and in out_edges().
+        g = BoostGraph(n_vertices);
+
+        for(uint32_t i = 0u; i < n_vertices; i++) {
+            g[i] = VertexInfo{i, {i}};
+            g.out_edge_list(i).reserve(degree[i]);
+        }
+
+        adj = AdjacencyMatrix(n_vertices);
+
+        for(auto e = 0u; e < n_edges; e++) {
+            add_edge(edge_ids[2u * e], edge_ids[2u * e + 1u], g);
+            adj.add_edge(edge_ids[2u * e], edge_ids[2u * e + 1u]);
+        }
+
+        p = Partition{std::vector<uint32_t>(offsets, offsets + n_partitions + 1u), std::vector<uint32_t>(elements, elements + h.n_elements)};
+        input_ids.assign(ids, ids + n_vertices);
+
+        index_vertices();
+
+        return true;
+    }
+
+    void Graph::build_adjacency_matrix() {
+        adj = AdjacencyMatrix(n_vertices);
+
+        for(auto it = edges(g); it.first != it.second; ++it.first) {
+            auto i = g[source(*it.first, g)].id;
+            auto j = g[target(*it.first, g)].id;
+            assert(i < n_vertices && j < n_vertices);
+            adj.add_edge(i, j);
+        }
+    }
+
     void Graph::renumber_vertices() {
-        std::unordered_map<uint32_t, uint32_t> rn;
+        std::vector<uint32_t> rn(id_index.size(), Partition::none);
         uint32_t n = 0u;
 
+        input_ids.clear();
+        input_ids.reserve(num_vertices(g));
+
         for(auto it = vertices(g); it.first != it.second; ++it.first) {
             auto v = *it.first;
+            input_ids.push_back(g[v].represented_vertices.front());
             rn[g[v].id] = n;
             g[v].id = n;
             g[v].represented_vertices = {n};
             n++;
         }
 
-        Partition new_p;
-        new_p.reserve(n_partitions);
-        
-        for(const auto& s : p) {
-            std::unordered_set<uint32_t> new_set;
-            for(const auto& id : s) {
-                new_set.insert(rn[id]);
-            }
-            new_p.push_back(new_set);
+        p.renumber(rn);
+
+        index_vertices();
+    }
+
+    void Graph::index_vertices() {
+        uint32_t max_id = 0u, max_original_id = 0u;
+
+        for(auto it = vertices(g); it.first != it.second; ++it.first) {
+            const auto& info = g[*it.first];
+            max_id = std::max(max_id, info.id + 1);
+            for(auto r_id : info.represented_vertices) { max_original_id = std::max(max_original_id, r_id + 1); }
+        }
+
+        id_index.assign(max_id, BoostGraph::null_vertex());
+        original_id_index.assign(max_original_id, BoostGraph::null_vertex());
+
+        for(auto it = vertices(g); it.first != it.second; ++it.first) {
+            const auto& info = g[*it.first];
+
+            assert(id_index[info.id] == BoostGraph::null_vertex());
+            id_index[info.id] = *it.first;
+
+            for(auto r_id : info.represented_vertices) { original_id_index[r_id] = *it.first; }
         }
-        
-        p = new_p;
     }
 
     void Graph::do_preprocessing() {
         DEBUG_ONLY(using namespace Console;)
 
-        // 1) If in a partition P there is a vertex v, which is only
-        // linked to other vertices of P, then I can remove the whole
-        // partition, because it is always possible to colour v, with
-        // any colour we want.
-        std::vector<uint32_t> removable;
-        for(auto k = 0u; k < p.size(); k++) {
-            for(auto v_id : p[k]) {
-                auto v = vertex_by_id(v_id);
-                assert(v);
+        // The reductions below are run on the adjacency matrix, restricted to the
+        // vertices not removed yet, until neither removes anything. Vertex ids are
+        // still 0, ..., n_vertices - 1 here.
+        Bitset alive{n_vertices};
+        for(auto i = 0u; i < n_vertices; i++) { alive.set(i); }
+
+        Bitset members{n_vertices};
+        std::vector<uint32_t> removed_partitions;
+        std::vector<uint32_t> removed_vertices;
+        std::vector<bool> partition_removed(p.size(), false);
+
+        for(auto round = 1u; ; round++) {
+            auto n_removed_partitions = removed_partitions.size();
+            auto n_removed_vertices = removed_vertices.size();
+
+            // 1) If in a partition P there is a vertex v, which is only
+            // linked to other vertices of P, then I can remove the whole
+            // partition, because it is always possible to colour v, with
+            // any colour we want.
+            for(auto k = 0u; k < p.size(); k++) {
+                if(partition_removed[k]) { continue; }
+
+                for(auto v_id : p[k]) { if(alive.test(v_id)) { members.set(v_id); } }
+
+                for(auto v_id : p[k]) {
+                    if(alive.test(v_id) && adj.neighbourhood_included(v_id, members, alive)) {
+                        for(auto w_id : p[k]) { alive.reset(w_id); }
+                        partition_removed[k] = true;
+                        removed_partitions.push_back(k);
+                        break;
+                    }
+                }
+
+                for(auto v_id : p[k]) { members.reset(v_id); }
+            }
 
-                auto it = out_edges(*v, g);
-                if(std::all_of(
-                    it.first, it.second,
-                    [&] (const auto& e) {
-                        auto w_id = g[target(e, g)].id;
-                        return std::find(p[k].begin(), p[k].end(), w_id) != p[k].end();
+            // 2) If v and w are two vertices in the same partition, and
+            // N(v) contains N(w), then I can remove v: in any solution
+            // in which I colour v, I can colour w with the same colour.
+            // Partitions are cliques, so the test is on closed neighbourhoods.
+            for(auto k = 0u; k < p.size(); k++) {
+                if(partition_removed[k] || p[k].size() < 2u) { continue; }
+
+                for(auto v_id : p[k]) {
+                    if(!alive.test(v_id)) { continue; }
+
+                    for(auto w_id : p[k]) {
+                        if(w_id != v_id && alive.test(w_id) && adj.closed_neighbourhood_included(w_id, v_id, alive)) {
+                            alive.reset(v_id);
+                            removed_vertices.push_back(v_id);
+                            break;
+                        }
                     }
-                )) {
-                    removable.push_back(k);
-                    break;
                 }
             }
-        }
-        remove_partitions(removable);
-        DEBUG_ONLY(std::cout << "Preprocessing removed " << removable.size() << " partitions." << std::endl;)
 
-        // 2) If v and w are two vertices in the same partition, and
-        // N(v) contains N(w), then I can remove v: in any solution
-        // in which I colour v, I can colour w with the same colour.
-        std::vector<Vertex> remove_v;
-        for(auto k = 0u; k < p.size(); k++) {
-            if(p[k].size() < 2u) { continue; }
-            for(const auto& i_id : p[k]) {
-                auto vi = vertex_by_id(i_id);
-                assert(vi);
-                for(const auto& j_id : p[k]) {
-                    if(j_id == i_id) { continue; }
+            DEBUG_ONLY(std::cout << "Preprocessing round " << round << " removed "
+                                 << removed_partitions.size() - n_removed_partitions << " partitions and "
+                                 << removed_vertices.size() - n_removed_vertices << " additional vertices." << std::endl;)
 
-                    auto vj = vertex_by_id(j_id);
-                    assert(vj);
+            if(removed_partitions.size() == n_removed_partitions && removed_vertices.size() == n_removed_vertices) { break; }
+        }
 
-                    auto it_i = out_edges(*vi, g);
-                    auto it_j = out_edges(*vj, g);
+        DEBUG_ONLY(std::cout << "Preprocessing removed " << removed_partitions.size() << " partitions and "
+                             << removed_vertices.size() << " additional vertices." << std::endl;)
 
-                    if(std::all_of(
-                        it_i.first,
-                        it_i.second,
-                        [&] (const auto& wi) { return std::find(it_j.first, it_j.second, wi) != it_j.second; }
-                    )) {
-                        remove_v.push_back(*vj);
-                        continue;
-                    }
+        if(removed_partitions.empty() && removed_vertices.empty()) { return; }
 
-                    if(std::all_of(
-                        it_j.first,
-                        it_j.second,
-                        [&] (const auto& wj) { return std::find(it_i.first, it_i.second, wj) != it_i.second; }
-                    )) {
-                        remove_v.push_back(*vi);
-                        break;
-                    }
-                }
-            }
-        }
-        for(auto v : remove_v) { erase_vertex(v); }
-        DEBUG_ONLY(std::cout << "Preprocessing removed " << remove_v.size() << " additional vertices." << std::endl;)
-    }
+        for(auto v_id : removed_vertices) { p.erase_vertex(v_id); }
+        std::sort(removed_partitions.begin(), removed_partitions.end());
+        p.erase_clusters(removed_partitions);
 
-    void Graph::erase_vertex(Vertex v) {
-        auto k = partition_for(g[v].id);
-        p[k].erase(g[v].id);
-        clear_vertex(v, g);
-        remove_vertex(v, g);
+        remove_vertices(alive);
     }
 
-    void Graph::remove_partitions(std::vector<uint32_t> removable) {
-        for(auto k : removable) {
-            while(!p[k].empty()) {
-                auto v = vertex_by_id(*p[k].begin());
-                assert(v);
+    void Graph::remove_vertices(const Bitset& keep) {
+        std::vector<Vertex> remove_v;
 
-                p[k].erase(p[k].begin());
-                clear_vertex(*v, g);
-                remove_vertex(*v, g);
-            }
+        for(auto it = vertices(g); it.first != it.second; ++it.first) {
+            if(!keep.test(g[*it.first].id)) { remove_v.push_back(*it.first); }
         }
-        p.erase(std::remove_if(p.begin(), p.end(), [] (const auto& s) { return s.empty(); }), p.end());
+
+        // Remove from the highest descriptor down, so that the ones still
+        // to be removed are not shifted by vecS.
+        for(auto it = remove_v.rbegin(); it != remove_v.rend(); ++it) {
+            clear_vertex(*it, g);
+            remove_vertex(*it, g);
+        }
+
+        index_vertices();
     }
 
     void Graph::make_partition_cliques() {
-        for(const auto& s : p) {
+        // The adjacency matrix answers the edge queries, and is kept up to date.
+        for(auto k = 0u; k < p.size(); k++) {
+            auto s = p[k];
             for(auto it = s.begin(); it != s.end(); ++it) {
                 auto vi = vertex_by_id(*it);
                 assert(vi);
@@ -251,7 +482,10 @@ namespace sgcp {
                     auto vj = vertex_by_id(*jt);
                     assert(vj);
 
-                    if(!edge(*vi, *vj, g).second) { add_edge(*vi, *vj, g); }
+                    if(!adj.connected(*it, *jt)) {
+                        add_edge(*vi, *vj, g);
+                        adj.add_edge(*it, *jt);
+                    }
                 }
             }
         }
@@ -264,7 +498,7 @@ namespace sgcp {
             uint32_t sets_n = 0u;
             uint32_t v_id = g[*vit.first].id;
 
-            for(const auto& s : p) { if(s.find(v_id) != s.end()) { sets_n++; } }
+            for(auto k = 0u; k < p.size(); k++) { if(p[k].contains(v_id)) { sets_n++; } }
 
             if(sets_n == 0u || (must_also_be_partition && sets_n > 1u)) {
                 DEBUG_ONLY(std::cerr << "Vertex " << g[*vit.first] << " is in " << sets_n << " partitions." << std::endl;)
@@ -283,37 +517,18 @@ namespace sgcp {
     }
 
     boost::optional<Vertex> Graph::vertex_by_id(uint32_t id) const {
-        for(auto it = vertices(g); it.first != it.second; ++it.first) {
-            if(g[*it.first].id == id) { return *it.first; }
-        }
-        return boost::none;
+        if(id >= id_index.size() || id_index[id] == BoostGraph::null_vertex()) { return boost::none; }
+        return id_index[id];
     }
 
     boost::optional<Vertex> Graph::vertex_by_original_id(uint32_t id) const {
-        for(auto it = vertices(g); it.first != it.second; ++it.first) {
-            Vertex v = *it.first;
-            if(g[v].represents(id)) { return v; }
-        }
-        return boost::none;
-    }
-
-    uint32_t Graph::partition_for(uint32_t i) const {
-        for(uint32_t k = 0u; k < n_partitions; k++) {
-            if(std::find(p[k].begin(), p[k].end(), i) != p[k].end()) { return k; }
-        }
-
-        // If we reach this point, there is a vertex that is in no partitions
-        assert(false); return n_vertices;
+        if(id >= original_id_index.size() || original_id_index[id] == BoostGraph::null_vertex()) { return boost::none; }
+        return original_id_index[id];
     }
 
     bool Graph::connected(uint32_t i, uint32_t j) const {
-        auto vi = vertex_by_id(i);
-        if(!vi) { return false; }
-
-        auto vj = vertex_by_id(j);
-        if(!vj) { return false; }
-
-        return edge(*vi, *vj, g).second;
+        if(i >= n_vertices || j >= n_vertices) { return false; }
+        return adj.connected(i, j);
     }
 
     bool Graph::connected_by_original_id(uint32_t i, uint32_t j) const {
@@ -323,10 +538,10 @@ namespace sgcp {
         auto vj = vertex_by_original_id(j);
         if(!vj) { return false; }
 
-        return edge(*vi, *vj, g).second;
+        return adj.connected(g[*vi].id, g[*vj].id);
     }
 
-    bool Graph::is_compatible_as_stable_set(const VertexIdSet& s) const {
+    bool Graph::is_compatible_as_stable_set(const std::vector<uint32_t>& s) const {
         // 1) It contains any removed vertex.
         for(auto id : s) {
             auto v = vertex_by_original_id(id);
@@ -341,7 +556,7 @@ namespace sgcp {
                 uint32_t covered_vertices = 0u;
 
                 for(auto r_id : g[*it.first].represented_vertices) {
-                    if(std::find(s.begin(), s.end(), r_id) != s.end()) { covered_vertices++; }
+                    if(std::binary_search(s.begin(), s.end(), r_id)) { covered_vertices++; }
                 }
 
                 if(covered_vertices != 0u && covered_vertices != g[*it.first].represented_vertices.size()) { return false; }
@@ -356,7 +571,7 @@ namespace sgcp {
                 auto vj = vertex_by_original_id(*jt);
                 assert(vj);
 
-                if(edge(*vi, *vj, g).second) { return false; }
+                if(adj.connected(g[*vi].id, g[*vj].id)) { return false; }
             }
         }
 
@@ -369,9 +584,12 @@ namespace sgcp {
 
         if(!v) { return n; }
 
+        auto v_id = g[*v].id;
+
         for(auto it = vertices(g); it.first != it.second; ++it.first) {
-            if(*it.first == *v && !including_itself) { continue; }
-            if(edge(*v, *it.first, g).second) { continue; }
+            auto w_id = g[*it.first].id;
+            if(w_id == v_id && !including_itself) { continue; }
+            if(adj.connected(v_id, w_id)) { continue; }
             std::copy(g[*it.first].represented_vertices.begin(), g[*it.first].represented_vertices.end(), std::inserter(n, n.end()));
         }
 
@@ -379,15 +597,14 @@ namespace sgcp {
     }
 
     VertexIdSet Graph::anti_neighbourhood_of(uint32_t i, bool including_itself) const {
-        auto v = vertex_by_id(i);
         VertexIdSet n;
 
-        if(!v) { return n; }
+        if(i >= n_vertices) { return n; }
 
-        for(auto it = vertices(g); it.first != it.second; ++it.first) {
-            if(*it.first == *v && !including_itself) { continue; }
-            if(edge(*v, *it.first, g).second) { continue; }
-            n.insert(g[*it.first].id);
+        for(auto j = 0u; j < n_vertices; j++) {
+            if(j == i && !including_itself) { continue; }
+            if(adj.connected(i, j)) { continue; }
+            n.insert(j);
         }
 
         return n;
@@ -2,6 +2,9 @@
 #define _GRAPH_HPP
 
 #include "params.hpp"
+#include "bitset.hpp"
+#include "adjacency_matrix.hpp"
+#include "partition.hpp"
 
 #include <boost/optional.hpp>
 #include <boost/graph/graph_traits.hpp>
@@ -32,15 +35,39 @@ namespace sgcp {
     using BoostGraph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS, VertexInfo>;
     using Vertex = boost::graph_traits<BoostGraph>::vertex_descriptor;
     using Edge = boost::graph_traits<BoostGraph>::edge_descriptor;
-    using Partition = std::vector<std::unordered_set<uint32_t>>;
     using WeightMap = std::map<uint32_t, float>;
     using VertexIdSet = std::unordered_set<uint32_t>;
 
     class Graph {
+        // Maps each vertex id to its vertex descriptor, and each original id to the
+        // descriptor of the vertex representing it. Ids not in the graph map to
+        // BoostGraph::null_vertex().
+        std::vector<Vertex> id_index;
+        std::vector<Vertex> original_id_index;
+
+        // Rebuilds the two indices above. Must be called every time the vertex set
+        // of the underlying BoostGraph changes, because removing a vertex shifts
+        // the descriptors of all the vertices after it.
+        void index_vertices();
+
+        // Builds the bitset adjacency matrix from the BoostGraph. Requires vertex
+        // ids to be 0, ..., n_vertices - 1.
+        void build_adjacency_matrix();
+
+        // Reads and preprocesses the instance file.
+        void read_text(const std::string& filename);
+
+        // Reads the graph saved by write_binary, if the file exists and was
+        // written from the current version of the instance file.
+        bool read_binary(const std::string& bin_filename);
+
         void renumber_vertices();
         void do_preprocessing();
-        void erase_vertex(Vertex v);
-        void remove_partitions(std::vector<uint32_t> removable);
+
+        // Removes from g the vertices whose id is not in keep (the partition
+        // must be updated separately).
+        void remove_vertices(const Bitset& keep);
+
         void make_partition_cliques();
         bool is_cover_or_partition_valid(bool must_also_be_partition) const;
 
@@ -53,11 +80,27 @@ namespace sgcp {
         Partition p;
         Params params;
 
+        // Same edges as g, indexed by vertex id, for constant-time adjacency queries.
+        AdjacencyMatrix adj;
+
         std::string data_filename;
 
+        // Id in the instance file of each vertex (by current id). Empty if the
+        // graph was not read from a file.
+        std::vector<uint32_t> input_ids;
+
+        // Reads the instance file, unless its binary file is up to date, in
+        // which case the (already preprocessed) graph is loaded from there.
         Graph(std::string filename, std::string params_filename);
         Graph(BoostGraph g, Partition p, Params params);
 
+        // Binary file of an instance: the instance file with extension .bin.
+        static std::string binary_filename_for(const std::string& filename);
+
+        // Saves the preprocessed graph, so that later runs on the same instance
+        // need neither parse the instance file nor preprocess the graph.
+        void write_binary(const std::string& bin_filename) const;
+
         // Checks that the partitions cover the whole graph and don't overlap.
         bool is_partition_valid() const;
 
@@ -69,6 +112,12 @@ namespace sgcp {
         bool connected(uint32_t i, uint32_t j) const;
         bool connected_by_original_id(uint32_t i, uint32_t j) const;
 
+        // Tells whether vertex i is linked to any vertex of s. Both refer to current ids.
+        bool adjacent_to_any(uint32_t i, const Bitset& s) const { return adj.adjacent_to_any(i, s); }
+
+        // Number of neighbours of vertex i (current id).
+        uint32_t degree(uint32_t i) const { return adj.degree(i); }
+
         // Returns a vertex by its id, if it exists.
         boost::optional<Vertex> vertex_by_id(uint32_t id) const;
 
@@ -77,11 +126,11 @@ namespace sgcp {
 
         // Check wether the provided stable set is compatible with the current graph.
         // The ids refer to the original ids. Causes of incompatibility stem from the
-        // modification (linking, merging, removal) to the graph.
-        bool is_compatible_as_stable_set(const VertexIdSet& s) const;
+        // modification (linking, merging, removal) to the graph. The ids must be sorted.
+        bool is_compatible_as_stable_set(const std::vector<uint32_t>& s) const;
 
         // Returns the index of the partition for a vertex with a certain id.
-        uint32_t partition_for(uint32_t i) const;
+        uint32_t partition_for(uint32_t i) const { assert(p.partition_of(i) != Partition::none); return p.partition_of(i); }
 
         // Returns the anti-neighbourhood of i, i.e. the ids of all the vertices that are
         // not linked to i by an edges. The first versions use current ids, the second original ids.
@@ -2,7 +2,7 @@
 #define _ALNS_HPP
 
 #include "../../graph.hpp"
-#include "../../branch-and-price/column_pool.hpp"
+#include "../../stable_set.hpp"
 #include "alns_colouring.hpp"
 #include "tabu_list.hpp"
 #include "destroy.hpp"
@@ -63,8 +63,8 @@ namespace sgcp {
         // Initialises and returns all repair moves.
         std::vector<std::unique_ptr<RepairMove>> initialise_repair_moves() const;
 
-        // Creates an initial solution, starting from a column pool.
-        ALNSColouring initial_solution(const ColumnPool& pool) const;
+        // Creates an initial solution, starting from a collection of stable sets.
+        ALNSColouring initial_solution(const StableSetCollection& pool) const;
 
         // Creates an initial solution, by first calling the constructive heuristics.
         ALNSColouring initial_solution() const;
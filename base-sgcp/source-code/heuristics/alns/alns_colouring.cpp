@@ -19,7 +19,7 @@ namespace sgcp {
         }
     }
 
-    ALNSColouring::ALNSColouring(const Graph& g, const ColumnPool& cp) : ALNSColouring{g} {
+    ALNSColouring::ALNSColouring(const Graph& g, const StableSetCollection& cp) : ALNSColouring{g} {
         for(auto c_id = 0u; c_id < cp.size(); ++c_id) {
             for(auto v_id : cp[c_id].get_set()) {
                 colour_vertex(v_id, c_id);
@@ -29,8 +29,8 @@ namespace sgcp {
         assert(is_valid());
     }
 
-    ColumnPool ALNSColouring::to_column_pool() const {
-        ColumnPool cp;
+    StableSetCollection ALNSColouring::to_column_pool() const {
+        StableSetCollection cp;
 
         for(const auto& col : colours) {
             cp.emplace_back(g.get(), col);
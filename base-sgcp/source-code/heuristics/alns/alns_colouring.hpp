@@ -2,7 +2,7 @@
 #define _ALNS_COLOURING_HPP
 
 #include "../../graph.hpp"
-#include "../../branch-and-price/column_pool.hpp"
+#include "../../stable_set.hpp"
 #include <vector>
 #include <random>
 
@@ -74,10 +74,10 @@ namespace sgcp {
         ALNSColouring(const Graph& g);
 
         // Creates a colouring for graph g, from a solution.
-        ALNSColouring(const Graph& g, const ColumnPool& cp);
+        ALNSColouring(const Graph& g, const StableSetCollection& cp);
 
-        // Gives a ColumnPool representing the colouring.
-        ColumnPool to_column_pool() const;
+        // Gives the stable sets representing the colouring.
+        StableSetCollection to_column_pool() const;
 
         // Removes coloured vertex v from its colour and puts it in the
         // uncoloured vertices pool. It update all other member variables
@@ -58,7 +58,7 @@ namespace sgcp {
         }
 
         for(auto k = 0u; k < g.n_partitions; k++) {
-            auto new_set = std::unordered_set<uint32_t>();
+            auto new_set = std::vector<uint32_t>();
             for(auto id : g.p[k]) {
                 if(std::find(coloured_v.begin(), coloured_v.end(), id) == coloured_v.end()) {
                     auto vit = vertices(new_bg);
@@ -66,7 +66,7 @@ namespace sgcp {
 
                     assert(new_v != vit.second);
 
-                    new_set.insert(*new_v);
+                    new_set.push_back(*new_v);
                 }
             }
             new_p.push_back(new_set);
@@ -75,17 +75,17 @@ namespace sgcp {
         return std::make_pair(Graph{new_bg, new_p, g.params}, new_wm);
     }
 
-    ColumnPool GRASPSolver::greedy_mwss_solve(WeightMap weights) const {
+    StableSetCollection GRASPSolver::greedy_mwss_solve(WeightMap weights) const {
         std::set<uint32_t> coloured_v;
-        ColumnPool cp;
+        StableSetCollection cp;
 
         while(coloured_v.size() < g.n_vertices) {
             auto red = reduce(g, weights, coloured_v);
             const auto& red_graph = red.first;
             const auto& red_weights = red.second;
 
-            auto solver = SewellMwssSolver{g, red_graph, red_weights};
-            auto solution = solver.solve();
+            auto solver = SewellMwssSolver{g, red_graph};
+            auto solution = solver.solve(red_weights);
 
             assert(solution);
 
@@ -123,8 +123,8 @@ namespace sgcp {
         return wm;
     }
 
-    ColumnPool GRASPSolver::solve() const {
-        boost::optional<ColumnPool> cp;
+    StableSetCollection GRASPSolver::solve() const {
+        boost::optional<StableSetCollection> cp;
         std::mutex cp_mtx;
         auto iter = 0u;
 
@@ -134,7 +134,7 @@ namespace sgcp {
             for(auto i = 0u; i < g.params.grasp_threads; ++i) {
                 threads.emplace_back([&] () noexcept {
                     WeightMap wm = this->make_random_weight_map();
-                    ColumnPool sol = this->greedy_mwss_solve(wm);
+                    StableSetCollection sol = this->greedy_mwss_solve(wm);
                     DecreaseByOneColourLocalSearch ls{g};
                     ALNSColouring col{g, sol};
 
@@ -5,7 +5,7 @@
 #ifndef SGCP_GRASP_HPP
 #define SGCP_GRASP_HPP
 
-#include "../branch-and-price/column_pool.hpp"
+#include "../stable_set.hpp"
 #include "../graph.hpp"
 
 namespace sgcp {
@@ -14,11 +14,11 @@ namespace sgcp {
 
     public:
         GRASPSolver(const Graph& g) : g{g} {}
-        ColumnPool solve() const;
+        StableSetCollection solve() const;
 
     private:
         std::pair<Graph, WeightMap> reduce(const Graph& g, const WeightMap& wm, const std::set<uint32_t>& coloured_v) const;
-        ColumnPool greedy_mwss_solve(WeightMap weights) const;
+        StableSetCollection greedy_mwss_solve(WeightMap weights) const;
         WeightMap make_random_weight_map() const;
     };
 }
@@ -10,7 +10,7 @@ namespace sgcp {
         auto pool = ColumnPool{};
         cache::init_update_pool(pool, g);
 
-        if(!pool.empty()) { return pool; }
+        if(!pool.empty()) { return pool.get_columns(); }
 
         auto simple_pool = solve_simple();
         auto improved_pool = solve_improved();
@@ -49,13 +49,7 @@ namespace sgcp {
                 for(auto w_id : g.p[k]) {
                     // Check if it can be added to the stable set, i.e. if
                     // it is not connected to some other vertex in the set.
-                    bool addable = std::none_of(
-                        sol.back().get_set().begin(),
-                        sol.back().get_set().end(),
-                        [&] (auto sv_id) {
-                            return g.connected(sv_id, w_id);
-                        }
-                    );
+                    bool addable = !g.adjacent_to_any(w_id, sol.back().get_vertices());
 
                     auto w = g.vertex_by_id(w_id);
                     assert(w);
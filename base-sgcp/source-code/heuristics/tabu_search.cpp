@@ -87,14 +87,11 @@ namespace sgcp {
         return (times_in_tabu != target_colours_n);
     }
     
-    uint32_t TabuSearchSolver::external_degree(Vertex vertex, uint32_t partition) const {
-        uint32_t degree = 0u;
+    uint32_t TabuSearchSolver::external_degree(uint32_t vertex, uint32_t partition) const {
+        uint32_t degree = g.degree(vertex);
         
-        for(auto it = out_edges(vertex, g.g); it.first != it.second; ++it.first) {
-            auto w = target(*it.first, g.g);
-            auto j = g.partition_for(g.g[w].id);
-            
-            if(j != partition) { degree++; }
+        for(auto w : g.p[partition]) {
+            if(g.connected(vertex, w)) { degree--; }
         }
         
         return degree;
@@ -115,23 +112,18 @@ namespace sgcp {
         // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=47679
         boost::optional<uint32_t> score = boost::make_optional(false, 0u);
         
-        auto v = g.vertex_by_id(vertex);
-        assert(v);
-        
         for(auto w_id : colouring_stable_sets[colour].get_set()) {
-            auto w = g.vertex_by_id(w_id);
-            assert(w);
-            if(edge(*v, *w, g.g).second) {
+            if(g.connected(vertex, w_id)) {
                 auto k = g.partition_for(w_id);
                 r.removed_vertices.push_back(w_id);
                 r.uncoloured_partitions.insert(k);
                 
-                if(!score) { score = external_degree(*w, k); }
+                if(!score) { score = external_degree(w_id, k); }
                 else {
                     if(g.params.tabu_score == "sum") {
-                        score = *score + external_degree(*w, k);
+                        score = *score + external_degree(w_id, k);
                     } else {
-                        score = std::min(*score, external_degree(*w, k));
+                        score = std::min(*score, external_degree(w_id, k));
                     }
                 }
             }
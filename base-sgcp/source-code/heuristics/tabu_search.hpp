@@ -76,7 +76,7 @@ namespace sgcp {
         
         // Gives the degree of the vertex, but only considering edges that
         // link it to vertices that are not in its same partition.
-        uint32_t external_degree(Vertex vertex, uint32_t partition) const;
+        uint32_t external_degree(uint32_t vertex, uint32_t partition) const;
     
         // Tells what would happen if a vertex were put in a certain
         // colour bucket. It assumes that the operation is legit, i.e.
@@ -2,6 +2,7 @@
 #include "stable_set.hpp"
 #include "solver_stats.hpp"
 #include "branch-and-price/bb_tree.hpp"
+#include "branch-and-price/checkpoint.hpp"
 #include "campelo-mip/campelo_mip_solver.hpp"
 #include "compact-mip/compact_mip_solver.hpp"
 #include "decomposition/decomposition_solver.hpp"
@@ -9,12 +10,16 @@
 #include "heuristics/tabu_search.hpp"
 #include "heuristics/greedy_heuristic.hpp"
 #include "heuristics/grasp.hpp"
+#include "mwss/sewell_mwss_solver.hpp"
+#include "mwss/bitset_mwss_solver.hpp"
 #include "utils/cache.hpp"
 
 #include <chrono>
+#include <random>
 
-std::array<std::string, 10> solvers = {
+std::array<std::string, 14> solvers = {
     "bp", // Branch-and-price
+    "bp-resume", // Branch-and-price, resumed from the instance's checkpoint
     "campelo", // Campelo's representatives model
     "compact", // Compact formulation without representatives
     "greedy", // Greedy initial heuristics
@@ -23,7 +28,10 @@ std::array<std::string, 10> solvers = {
     "tabu", // TABU Search heuristic
     "grasp", // GRASP heuristic
     "decomposition", // Benders-like decomposition solver
+    "mwss-benchmark", // Compare the MWSS solvers used in pricing
     "info", // Just print graph info
+    "preprocess", // Save the preprocessed graph next to the instance, for later runs
+    "import-csv-cache", // Copy the instance's solutions from the old bks.csv/init.csv into the binary caches
 };
 
 bool file_exists(const std::string& file_name) {
@@ -58,6 +66,27 @@ void solve_bp(std::shared_ptr<sgcp::Graph> g) {
     }
 }
 
+void solve_bp_resume(std::shared_ptr<sgcp::Graph> g) {
+    auto checkpoint_file = sgcp::Checkpoint::filename_for(*g);
+
+    if(!file_exists(checkpoint_file)) {
+        std::cerr << "Cannot find checkpoint file: " << checkpoint_file << std::endl;
+        return;
+    }
+
+    sgcp::BBTree bb_tree{g, checkpoint_file};
+    auto sol = bb_tree.solve();
+
+    // Write statistics and results to file:
+    bb_tree.write_results();
+
+    print_solution(sol);
+
+    if(sol) {
+        sgcp::cache::bks_update_cache(*sol, *g);
+    }
+}
+
 void solve_campelo(std::shared_ptr<sgcp::Graph> g) {
     sgcp::CampeloMipSolver solver{*g};
     auto sol = solver.solve();
@@ -128,6 +157,57 @@ void solve_decomposition(std::shared_ptr<sgcp::Graph> g) {
     c.solve();
 }
 
+void benchmark_mwss(std::shared_ptr<sgcp::Graph> g) {
+    using namespace std::chrono;
+
+    // Number of weight vectors to try.
+    constexpr uint32_t n_rounds = 100u;
+
+    // As in the pricing, all vertices of a partition have the same weight.
+    std::mt19937 mt{1u};
+    std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+
+    auto sewell = sgcp::SewellMwssSolver{*g, *g};
+    auto bitset = sgcp::BitsetMwssSolver{*g, *g};
+
+    float sewell_time = 0, bitset_time = 0;
+    uint32_t mismatches = 0u;
+
+    auto weight_of = [&] (const sgcp::WeightMap& w, const boost::optional<sgcp::StableSet>& s) {
+        float weight = 0;
+        if(s) { for(auto v_id : s->get_set()) { weight += w.at(v_id); } }
+        return weight;
+    };
+
+    for(auto round = 0u; round < n_rounds; ++round) {
+        std::vector<float> duals(g->n_partitions);
+        for(auto& d : duals) { d = dist(mt); }
+
+        sgcp::WeightMap w;
+        for(auto v_id = 0u; v_id < g->n_vertices; ++v_id) { w[v_id] = duals[g->partition_for(v_id)]; }
+
+        auto stime = high_resolution_clock::now();
+        auto sewell_sol = sewell.solve(w);
+        auto mtime = high_resolution_clock::now();
+        auto bitset_sol = bitset.solve(w);
+        auto etime = high_resolution_clock::now();
+
+        sewell_time += duration_cast<duration<float>>(mtime - stime).count();
+        bitset_time += duration_cast<duration<float>>(etime - mtime).count();
+
+        // Both solvers round the weights in the same way, so the optima should match.
+        if(std::abs(weight_of(w, sewell_sol) - weight_of(w, bitset_sol)) > 1e-3) { ++mismatches; }
+    }
+
+    std::cout << g->data_filename << ","
+              << g->n_vertices << ","
+              << g->n_edges << ","
+              << n_rounds << ","
+              << sewell_time << ","
+              << bitset_time << ","
+              << mismatches << std::endl;
+}
+
 int main(int argc [[maybe_unused]], char* argv[]) {
     using namespace sgcp;
 
@@ -154,6 +234,8 @@ int main(int argc [[maybe_unused]], char* argv[]) {
 
     if(solver == "bp") {
         solve_bp(g);
+    } else if(solver == "bp-resume") {
+        solve_bp_resume(g);
     } else if(solver == "campelo") {
         solve_campelo(g);
     } else if(solver == "compact") {
@@ -170,8 +252,16 @@ int main(int argc [[maybe_unused]], char* argv[]) {
         solve_grasp(g);
     } else if(solver == "decomposition") {
         solve_decomposition(g);
+    } else if(solver == "mwss-benchmark") {
+        benchmark_mwss(g);
     } else if(solver == "info") {
         std::cout << g->data_filename << "," << g->n_vertices << "," << g->n_edges << "," << g->n_partitions << std::endl;
+    } else if(solver == "preprocess") {
+        auto bin_file = Graph::binary_filename_for(instance_file);
+        g->write_binary(bin_file);
+        std::cout << bin_file << std::endl;
+    } else if(solver == "import-csv-cache") {
+        sgcp::cache::import_csv_caches(*g);
     } else {
         assert(false);
     }
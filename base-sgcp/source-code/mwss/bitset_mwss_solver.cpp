@@ -0,0 +1,188 @@
+#include "bitset_mwss_solver.hpp"
+
+#include <cmath>
+#include <numeric>
+
+namespace sgcp {
+    BitsetMwssSolver::BitsetMwssSolver(const Graph& o, const Graph& g) :
+        o{o}, g{g}, multiplier{o.params.mwss_multiplier}, n_words{Bitset::words_for(g.n_vertices)},
+        order(g.n_vertices), weight(g.n_vertices, 0u),
+        rows(static_cast<std::size_t>(g.n_vertices) * n_words, 0u),
+        candidates(static_cast<std::size_t>(g.n_vertices + 1u) * n_words, 0u), clique(n_words, 0u),
+        residual(g.n_vertices, 0u),
+        cover(g.n_vertices + 1u), cover_bound(g.n_vertices + 1u),
+        current_weight{0u}, best_weight{0u}, goal_weight{0u}, goal_reached{false}
+    {
+        assert(g.adj.n_words() == n_words);
+
+        // Start from the identity order, for which the rows are the ones of the graph.
+        std::iota(order.begin(), order.end(), 0u);
+        for(auto i = 0u; i < g.n_vertices; ++i) {
+            std::copy(g.adj.row(i), g.adj.row(i) + n_words, rows.begin() + static_cast<std::ptrdiff_t>(i) * n_words);
+        }
+    }
+
+    Bitset::Word* BitsetMwssSolver::candidates_at(uint32_t depth) const {
+        assert(depth <= g.n_vertices);
+        return candidates.data() + static_cast<std::size_t>(depth) * n_words;
+    }
+
+    void BitsetMwssSolver::reorder(const WeightMap& w) const {
+        std::vector<uint64_t> id_weight(g.n_vertices, 0u);
+        for(const auto& kv : w) {
+            if(kv.second > eps) { id_weight[kv.first] = static_cast<uint64_t>(multiplier * kv.second); }
+        }
+
+        auto new_order = order;
+        std::stable_sort(new_order.begin(), new_order.end(), [&] (uint32_t i, uint32_t j) { return id_weight[i] > id_weight[j]; });
+
+        if(new_order != order) {
+            order = new_order;
+
+            std::vector<uint32_t> position(g.n_vertices);
+            for(auto i = 0u; i < g.n_vertices; ++i) { position[order[i]] = i; }
+
+            std::fill(rows.begin(), rows.end(), 0u);
+
+            for(auto i = 0u; i < g.n_vertices; ++i) {
+                const auto* id_row = g.adj.row(order[i]);
+                auto* pos_row = rows.data() + static_cast<std::size_t>(i) * n_words;
+
+                for(auto wd = 0u; wd < n_words; ++wd) {
+                    for(Word word = id_row[wd]; word != 0u; word &= word - 1u) {
+                        auto j = position[wd * Bitset::word_bits + static_cast<uint32_t>(__builtin_ctzll(word))];
+                        pos_row[j / Bitset::word_bits] |= Word{1u} << (j % Bitset::word_bits);
+                    }
+                }
+            }
+        }
+
+        for(auto i = 0u; i < g.n_vertices; ++i) { weight[i] = id_weight[order[i]]; }
+    }
+
+    void BitsetMwssSolver::colour(uint32_t depth) const {
+        auto& cv = cover[depth];
+        auto& cb = cover_bound[depth];
+        cv.clear();
+        cb.clear();
+
+        // The next depth's buffer is free until the search moves there.
+        const auto* p = candidates_at(depth);
+        auto* uncovered = candidates_at(depth + 1u);
+        std::copy(p, p + n_words, uncovered);
+
+        for(auto wd = 0u; wd < n_words; ++wd) {
+            for(Word word = p[wd]; word != 0u; word &= word - 1u) {
+                auto v = wd * Bitset::word_bits + static_cast<uint32_t>(__builtin_ctzll(word));
+                residual[v] = weight[v];
+            }
+        }
+
+        uint64_t bound = 0u;
+
+        for(auto start = 0u; start < n_words;) {
+            if(uncovered[start] == 0u) { ++start; continue; }
+
+            // The clique takes the residual weight of its first vertex, which is then
+            // subtracted from all its vertices: a vertex leaves the cover when its whole
+            // weight has been accounted for.
+            std::copy(uncovered + start, uncovered + n_words, clique.begin() + start);
+            auto clique_weight = residual[start * Bitset::word_bits + static_cast<uint32_t>(__builtin_ctzll(uncovered[start]))];
+            bound += clique_weight;
+
+            for(auto wd = start; wd < n_words;) {
+                if(clique[wd] == 0u) { ++wd; continue; }
+
+                auto v = wd * Bitset::word_bits + static_cast<uint32_t>(__builtin_ctzll(clique[wd]));
+
+                if(residual[v] <= clique_weight) {
+                    residual[v] = 0u;
+                    uncovered[wd] &= ~(Word{1u} << (v % Bitset::word_bits));
+                    cv.push_back(v);
+                    cb.push_back(bound);
+                } else {
+                    residual[v] -= clique_weight;
+                }
+
+                // Only the neighbours of v can stay in the same clique (v is not its own neighbour).
+                const auto* r = row(v);
+                for(auto k = wd; k < n_words; ++k) { clique[k] &= r[k]; }
+            }
+        }
+    }
+
+    void BitsetMwssSolver::expand(uint32_t depth) const {
+        colour(depth);
+
+        const auto& cv = cover[depth];
+        const auto& cb = cover_bound[depth];
+        auto* p = candidates_at(depth);
+        auto* next = candidates_at(depth + 1u);
+
+        // Branch on the vertices with the largest bounds first.
+        for(auto i = cv.size(); i-- > 0u;) {
+            if(current_weight + cb[i] <= best_weight) { return; }
+
+            auto v = cv[i];
+            auto v_word = v / Bitset::word_bits;
+            auto v_bit = Word{1u} << (v % Bitset::word_bits);
+
+            const auto* r = row(v);
+            Word any = 0u;
+            p[v_word] &= ~v_bit;
+            for(auto k = 0u; k < n_words; ++k) {
+                next[k] = p[k] & ~r[k];
+                any |= next[k];
+            }
+
+            current.push_back(v);
+            current_weight += weight[v];
+
+            if(current_weight > best_weight) {
+                best = current;
+                best_weight = current_weight;
+                if(best_weight >= goal_weight) { goal_reached = true; }
+            }
+
+            if(!goal_reached && any) { expand(depth + 1u); }
+
+            current.pop_back();
+            current_weight -= weight[v];
+
+            if(goal_reached) { return; }
+        }
+    }
+
+    boost::optional<StableSet> BitsetMwssSolver::solve(const WeightMap& w, float lower_bound, float goal) const {
+        assert(w.size() == g.n_vertices);
+
+        reorder(w);
+
+        auto* root = candidates_at(0u);
+        std::fill(root, root + n_words, 0u);
+        for(auto i = 0u; i < g.n_vertices && weight[i] > 0u; ++i) {
+            root[i / Bitset::word_bits] |= Word{1u} << (i % Bitset::word_bits);
+        }
+
+        auto max_weight = static_cast<double>(std::numeric_limits<uint64_t>::max());
+        auto goal_scaled = static_cast<double>(multiplier) * static_cast<double>(goal);
+
+        current.clear();
+        best.clear();
+        current_weight = 0u;
+        best_weight = static_cast<uint64_t>(std::max(0.0, static_cast<double>(multiplier) * static_cast<double>(lower_bound)));
+        goal_weight = goal_scaled >= max_weight ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(std::ceil(goal_scaled));
+        goal_reached = false;
+
+        if(g.n_vertices > 0u) { expand(0u); }
+
+        VertexIdSet s;
+        for(auto i : best) {
+            auto v = g.vertex_by_id(order[i]);
+            assert(v);
+            for(auto orig_id : g.g[*v].represented_vertices) { s.insert(orig_id); }
+        }
+
+        return StableSet{o, s};
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef _BITSET_MWSS_SOLVER_HPP
+#define _BITSET_MWSS_SOLVER_HPP
+
+#include "../graph.hpp"
+#include "../stable_set.hpp"
+
+#include <limits>
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace sgcp {
+    // Branch-and-bound for the Maximum Weight Stable Set problem, working on
+    // packed bitsets. Vertices are renumbered by decreasing weight, and each node
+    // of the search tree bounds its candidate set with a greedy cover by cliques of
+    // the graph: a stable set takes at most one vertex from each clique, so the sum
+    // of the heaviest weights of the cliques is an upper bound. Cliques are built
+    // with word-wise ANDs of adjacency rows, which the compiler vectorises.
+    // The data structures are built once for a graph and reused by every call to
+    // solve; the renumbered adjacency is only rebuilt when the order changes.
+    class BitsetMwssSolver {
+        using Word = Bitset::Word;
+
+        // Original graph, before any branching rules modified it
+        const Graph& o;
+
+        const Graph& g;
+
+        uint32_t multiplier;
+        uint32_t n_words;
+
+        // Position -> vertex id, in the current order (by decreasing weight).
+        mutable std::vector<uint32_t> order;
+
+        // Integer weights and adjacency rows, indexed by position.
+        mutable std::vector<uint64_t> weight;
+        mutable Bitset::Storage rows;
+
+        // Candidate sets, one per depth of the search tree.
+        mutable Bitset::Storage candidates;
+
+        // Scratch space for the clique being built by colour.
+        mutable Bitset::Storage clique;
+
+        // Part of each candidate's weight not yet covered by a clique, used by colour.
+        mutable std::vector<uint64_t> residual;
+
+        // Vertices of each depth's candidate set, grouped by clique, with the
+        // corresponding cumulative upper bounds.
+        mutable std::vector<std::vector<uint32_t>> cover;
+        mutable std::vector<std::vector<uint64_t>> cover_bound;
+
+        mutable std::vector<uint32_t> current;
+        mutable std::vector<uint32_t> best;
+        mutable uint64_t current_weight;
+        mutable uint64_t best_weight;
+        mutable uint64_t goal_weight;
+        mutable bool goal_reached;
+
+        static constexpr float eps = 1e-6;
+
+        const Word* row(uint32_t i) const { return rows.data() + static_cast<std::size_t>(i) * n_words; }
+        Word* candidates_at(uint32_t depth) const;
+
+        // Sorts the vertices by decreasing weight (keeping the previous order between ties)
+        // and, if the order changed, renumbers the adjacency rows accordingly.
+        void reorder(const WeightMap& w) const;
+
+        // Covers the candidate set at the given depth with cliques, and fills in
+        // cover[depth] and cover_bound[depth].
+        void colour(uint32_t depth) const;
+
+        void expand(uint32_t depth) const;
+
+    public:
+        BitsetMwssSolver(const Graph& o, const Graph& g);
+
+        // Solves the Maximum Weight Stable Set problem on the graph, with the given weights.
+        // Only stable sets heavier than lower_bound are considered, and the search stops as soon
+        // as it finds one whose weight is at least goal. If there is no stable set heavier than
+        // lower_bound, returns an empty set.
+        boost::optional<StableSet> solve(const WeightMap& w, float lower_bound = 1.0f, float goal = std::numeric_limits<float>::max()) const;
+    };
+}
+
+#endif
@@ -1,7 +1,17 @@
 #include "mwss_solver.hpp"
 #include "sewell_mwss_solver.hpp"
+#include "bitset_mwss_solver.hpp"
+
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
 
 namespace sgcp {
+    MwssSolver::MwssSolver(const Graph& o, const Graph& g) : o{o}, g{g} {}
+
+    MwssSolver::~MwssSolver() = default;
+
     WeightMap MwssSolver::make_weight_map(const MpSolution& mpsol) const {
         WeightMap w;
 
@@ -20,18 +30,297 @@ namespace sgcp {
         return w;
     }
 
-    std::vector<StableSet> MwssSolver::solve(const MpSolution& mpsol) const {
-        auto solutions = std::vector<StableSet>{};
-        auto w = make_weight_map(mpsol);
+    std::vector<bool> MwssSolver::pricing_vertices(const std::vector<float>& w) const {
+        std::vector<bool> keep(g.n_vertices);
+        for(auto v_id = 0u; v_id < g.n_vertices; ++v_id) { keep[v_id] = w[v_id] > eps; }
+
+        // Ties are broken by id, so that only one of two equivalent vertices is removed.
+        auto heavier = [&] (uint32_t v_id, uint32_t u_id) { return w[v_id] > w[u_id] || (!(w[v_id] < w[u_id]) && v_id < u_id); };
+
+        // Domination is transitive, so a vertex can be removed even if its dominator is removed too.
+        for(auto k = 0u; k < g.n_partitions; ++k) {
+            for(auto u_id : g.p[k]) {
+                if(!keep[u_id]) { continue; }
+
+                for(auto v_id : g.p[k]) {
+                    if(v_id != u_id && heavier(v_id, u_id) && g.adj.closed_neighbourhood_included(v_id, u_id)) {
+                        keep[u_id] = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        return keep;
+    }
+
+    float MwssSolver::clique_cover_bound(const std::vector<float>& w, const std::vector<uint32_t>& order) const {
+        const auto n_words = g.adj.n_words();
+
+        // Common neighbours of the vertices of each clique, one row per clique.
+        Bitset::Storage common;
+        std::size_t n_cliques = 0u;
+        float bound = 0;
+
+        for(auto v_id : order) {
+            if(w[v_id] < eps) { break; }
+
+            auto v_word = v_id / Bitset::word_bits;
+            auto v_bit = Bitset::Word{1u} << (v_id % Bitset::word_bits);
+
+            auto k = 0u;
+            while(k < n_cliques && (common[k * n_words + v_word] & v_bit) == 0u) { ++k; }
+
+            const auto* r = g.adj.row(v_id);
+
+            if(k == n_cliques) {
+                // Vertices come by decreasing weight, so v is the heaviest of its clique.
+                bound += w[v_id];
+                common.insert(common.end(), r, r + n_words);
+                ++n_cliques;
+            } else {
+                auto* c = common.data() + k * n_words;
+                for(auto i = 0u; i < n_words; ++i) { c[i] &= r[i]; }
+            }
+        }
+
+        return bound;
+    }
+
+    std::vector<uint32_t> MwssSolver::by_decreasing_weight(const std::vector<float>& w) const {
+        std::vector<uint32_t> order(g.n_vertices);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&] (uint32_t i, uint32_t j) { return w[i] > w[j]; });
+        return order;
+    }
 
-        auto sew_solv = SewellMwssSolver{o, g, w};
-        auto solution = sew_solv.solve();
+    void MwssSolver::extend(std::vector<uint32_t>& s, const std::vector<uint32_t>& order, boost::optional<uint32_t> banned) const {
+        Bitset in_set{g.n_vertices};
+        std::vector<bool> covered(g.n_partitions, false);
 
-        if(solution) {
-          assert(solution->is_valid(true));
-          solutions.push_back(*solution);
+        for(auto v_id : s) {
+            in_set.set(v_id);
+            covered[g.partition_for(v_id)] = true;
         }
 
+        for(auto v_id : order) {
+            if(banned && v_id == *banned) { continue; }
+            if(covered[g.partition_for(v_id)]) { continue; }
+            if(g.adjacent_to_any(v_id, in_set)) { continue; }
+
+            s.push_back(v_id);
+            in_set.set(v_id);
+            covered[g.partition_for(v_id)] = true;
+        }
+    }
+
+    void MwssSolver::local_search(std::vector<uint32_t>& s, const std::vector<float>& w, const std::vector<uint32_t>& order) const {
+        bool improved = true;
+
+        while(improved) {
+            improved = false;
+
+            for(auto u_id : order) {
+                // Vertices are sorted by weight, so no later vertex can improve the set.
+                if(w[u_id] < eps) { break; }
+                if(std::find(s.begin(), s.end(), u_id) != s.end()) { continue; }
+
+                auto k = g.partition_for(u_id);
+                auto conflicts = [&] (uint32_t v_id) { return g.connected(u_id, v_id) || g.partition_for(v_id) == k; };
+
+                float loss = 0;
+                for(auto v_id : s) { if(conflicts(v_id)) { loss += w[v_id]; } }
+
+                if(w[u_id] > loss + eps) {
+                    s.erase(std::remove_if(s.begin(), s.end(), conflicts), s.end());
+                    s.push_back(u_id);
+                    extend(s, order);
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    StableSet MwssSolver::to_column(const std::vector<uint32_t>& s) const {
+        std::vector<uint32_t> orig;
+
+        for(auto v_id : s) {
+            auto v = g.vertex_by_id(v_id);
+            assert(v);
+            orig.insert(orig.end(), g.g[*v].represented_vertices.begin(), g.g[*v].represented_vertices.end());
+        }
+
+        return StableSet{o, orig};
+    }
+
+    std::vector<StableSet> MwssSolver::solve_heuristically(const MpSolution& mpsol, const std::vector<float>& w, const std::vector<uint32_t>& order, float min_reduced_cost) const {
+        std::vector<uint32_t> seeds;
+        for(auto v_id : order) {
+            if(seeds.size() >= o.params.pricing_heuristic_seeds || w[v_id] < eps) { break; }
+            seeds.push_back(v_id);
+        }
+
+        auto n_threads = std::max(1u, std::min<uint32_t>(o.params.pricing_heuristic_threads, seeds.size()));
+        std::vector<std::vector<std::vector<uint32_t>>> sets(n_threads);
+
+        auto work = [&] (uint32_t t) {
+            for(auto i = t; i < seeds.size(); i += n_threads) {
+                std::vector<uint32_t> s{seeds[i]};
+                extend(s, order);
+                local_search(s, w, order);
+                sets[t].push_back(s);
+            }
+        };
+
+        if(n_threads == 1u) {
+            work(0u);
+        } else {
+            std::vector<std::thread> threads;
+            for(auto t = 0u; t < n_threads; ++t) { threads.emplace_back(work, t); }
+            for(auto& thread : threads) { thread.join(); }
+        }
+
+        std::vector<StableSet> solutions;
+        std::unordered_set<StableSet> found;
+
+        for(const auto& thread_sets : sets) {
+            for(const auto& s : thread_sets) {
+                auto col = to_column(s);
+                if(col.reduced_cost(mpsol.duals) > min_reduced_cost && found.insert(col).second) {
+                    assert(col.is_valid(true));
+                    solutions.push_back(col);
+                }
+            }
+        }
+
+        // Keep the most violated columns.
+        std::sort(solutions.begin(), solutions.end(), [&] (const auto& s1, const auto& s2) { return s1.reduced_cost(mpsol.duals) > s2.reduced_cost(mpsol.duals); });
+        if(solutions.size() > o.params.pricing_max_columns) { solutions.erase(solutions.begin() + o.params.pricing_max_columns, solutions.end()); }
+
         return solutions;
     }
+
+    MwssSolution MwssSolver::solve_exactly(const MpSolution& mpsol, const WeightMap& wm, const std::vector<float>& w, const std::vector<uint32_t>& order, float min_reduced_cost) const {
+        auto solutions = std::vector<StableSet>{};
+        auto solution = boost::optional<StableSet>{};
+
+        // The weight of a column is its reduced cost, so it can be used as the goal directly.
+        auto goal = o.params.pricing_early_exit ? min_reduced_cost : std::numeric_limits<float>::max();
+
+        auto weights = wm;
+
+        if(o.params.pricing_reduce_graph) {
+            auto keep = pricing_vertices(w);
+
+            // Without vertices of positive weight there can be no improving column.
+            if(std::none_of(keep.begin(), keep.end(), [] (bool k) { return k; })) { return MwssSolution{solutions, true, min_reduced_cost}; }
+
+            // Both exact solvers are built once for g and reused, so instead of solving on
+            // the reduced graph, the removed vertices are given weight zero: some optimal
+            // stable set does without them.
+            for(auto v_id = 0u; v_id < g.n_vertices; ++v_id) { if(!keep[v_id]) { weights[v_id] = 0; } }
+        }
+
+        if(o.params.pricing_exact_solver == "bitset") {
+            if(!bitset) { bitset = std::make_unique<BitsetMwssSolver>(o, g); }
+            solution = bitset->solve(weights, 1.0f, goal);
+        } else {
+            if(!sewell) { sewell = std::make_unique<SewellMwssSolver>(o, g); }
+            solution = sewell->solve(weights, 1.0f, goal);
+        }
+
+        if(!solution) { return MwssSolution{solutions, true, min_reduced_cost}; }
+
+        assert(solution->is_valid(true));
+
+        // If the search stopped at the goal, the column is improving but possibly not optimal;
+        // otherwise the search was complete, and no further call is needed to prove optimality.
+        auto optimal = !o.params.pricing_early_exit || solution->reduced_cost(mpsol.duals) <= min_reduced_cost;
+
+        // Bring the optimal stable set back to the local graph.
+        std::vector<uint32_t> best;
+        for(auto orig_id : solution->get_set()) {
+            auto v = g.vertex_by_original_id(orig_id);
+            assert(v);
+            best.push_back(g.g[*v].id);
+        }
+        std::sort(best.begin(), best.end());
+        best.erase(std::unique(best.begin(), best.end()), best.end());
+
+        auto max_columns = o.params.pricing_max_columns;
+        std::unordered_set<StableSet> found;
+
+        auto add_if_improving = [&] (std::vector<uint32_t> s) {
+            if(solutions.size() >= max_columns) { return; }
+
+            // Skip the sets dominated by the optimal one.
+            auto col = to_column(s);
+            if(col.get_vertices().is_subset_of(solutions.front().get_vertices())) { return; }
+
+            if(col.reduced_cost(mpsol.duals) > min_reduced_cost && found.insert(col).second) {
+                assert(col.is_valid(true));
+                solutions.push_back(col);
+            }
+        };
+
+        // The optimal stable set, extended to a maximal one: it covers some more
+        // partitions, at no cost in terms of reduced cost.
+        auto best_ext = best;
+        extend(best_ext, order);
+        solutions.push_back(to_column(best_ext));
+        found.insert(solutions.back());
+
+        // Variants of the optimal set, in which one vertex (starting from the lightest)
+        // is replaced by a greedy completion.
+        auto best_by_weight = best;
+        std::sort(best_by_weight.begin(), best_by_weight.end(), [&] (uint32_t i, uint32_t j) { return w[i] < w[j]; });
+
+        for(auto v_id : best_by_weight) {
+            if(solutions.size() >= max_columns) { break; }
+
+            std::vector<uint32_t> s;
+            std::copy_if(best.begin(), best.end(), std::back_inserter(s), [&] (uint32_t u_id) { return u_id != v_id; });
+            extend(s, order, v_id);
+            add_if_improving(s);
+        }
+
+        // Greedy sets seeded with the heaviest vertices outside the optimal set.
+        auto seeds = 0u;
+        for(auto v_id : order) {
+            if(solutions.size() >= max_columns || seeds++ >= max_columns) { break; }
+            if(std::binary_search(best.begin(), best.end(), v_id)) { continue; }
+
+            std::vector<uint32_t> s{v_id};
+            extend(s, order);
+            add_if_improving(s);
+        }
+
+        // The exact solvers only look for sets heavier than min_reduced_cost, so the optimal column
+        // bounds the others only from there up. Without optimality, the bound is left to solve.
+        auto upper_bound = optimal ? std::max(min_reduced_cost, solutions.front().reduced_cost(mpsol.duals)) : std::numeric_limits<float>::max();
+
+        return MwssSolution{solutions, optimal, upper_bound};
+    }
+
+    MwssSolution MwssSolver::solve(const MpSolution& mpsol, float min_reduced_cost) const {
+        auto wm = make_weight_map(mpsol);
+
+        std::vector<float> w(g.n_vertices);
+        for(const auto& kv : wm) { w[kv.first] = kv.second; }
+
+        auto order = by_decreasing_weight(w);
+
+        if(o.params.pricing_heuristic) {
+            auto columns = solve_heuristically(mpsol, w, order, min_reduced_cost);
+            if(!columns.empty()) { return MwssSolution{columns, false, clique_cover_bound(w, order)}; }
+        }
+
+        // The exact pricing is only skipped when the heuristic finds some improving column,
+        // therefore column generation at each node still ends with a proof of optimality.
+        auto solution = solve_exactly(mpsol, wm, w, order, min_reduced_cost);
+        if(!solution.optimal) { solution.upper_bound = clique_cover_bound(w, order); }
+
+        return solution;
+    }
 }
@@ -4,20 +4,91 @@
 #include "../graph.hpp"
 #include "../branch-and-price/mp_solution.hpp"
 
+#include <memory>
 #include <vector>
+#include <boost/optional.hpp>
 
 namespace sgcp {
+    class SewellMwssSolver;
+    class BitsetMwssSolver;
+
+    struct MwssSolution {
+        // Columns found by the pricing; if the pricing was solved exactly,
+        // the first one is the optimal one.
+        std::vector<StableSet> columns;
+
+        // Tells whether the pricing problem was solved to optimality.
+        bool optimal;
+
+        // Upper bound on the reduced cost of any column, for the duals which were priced.
+        // It is the optimal column's reduced cost if the pricing was solved to optimality,
+        // and the bound of a clique cover of the graph otherwise.
+        float upper_bound;
+    };
+
     class MwssSolver {
         const Graph& o;
         const Graph& g;
 
+        // Exact solvers for the local graph (only the one chosen in params.pricing_exact_solver
+        // is used). The chosen one is only built the first time the exact pricing is needed, and then
+        // reused for all the following pricing rounds.
+        mutable std::unique_ptr<SewellMwssSolver> sewell;
+        mutable std::unique_ptr<BitsetMwssSolver> bitset;
+
+        static constexpr float eps = 1e-6;
+
         WeightMap make_weight_map(const MpSolution& mpsol) const;
 
+        // Tells which vertices of g can be in an optimal stable set: those with positive weight,
+        // and which are not dominated by another vertex of their partition. Vertex v dominates u
+        // if it is at least as heavy and its closed neighbourhood is contained in the one of u,
+        // as v can then replace u in any stable set.
+        std::vector<bool> pricing_vertices(const std::vector<float>& w) const;
+
+        // Covers the vertices of positive weight with cliques, greedily and by decreasing
+        // weight, and returns the sum of the heaviest weight of each clique: a stable set
+        // takes at most one vertex from each clique, so this bounds its weight.
+        float clique_cover_bound(const std::vector<float>& w, const std::vector<uint32_t>& order) const;
+
+        // Ids of the vertices of g, sorted by decreasing weight.
+        std::vector<uint32_t> by_decreasing_weight(const std::vector<float>& w) const;
+
+        // Greedily adds vertices to s (a stable set of g, by current ids), trying them in the
+        // given order, until it is maximal. Vertices whose partition is already covered by s
+        // are skipped, as they would not change the reduced cost. The banned vertex, if any,
+        // is never added.
+        void extend(std::vector<uint32_t>& s, const std::vector<uint32_t>& order, boost::optional<uint32_t> banned = boost::none) const;
+
+        // Improves s with (1, k)-swaps: a vertex is put in the set if it is heavier than
+        // all the vertices it conflicts with (adjacent or in the same partition), which are
+        // removed; the set is then extended again.
+        void local_search(std::vector<uint32_t>& s, const std::vector<float>& w, const std::vector<uint32_t>& order) const;
+
+        // Translates a stable set of g (by current ids) into a column on the original graph.
+        StableSet to_column(const std::vector<uint32_t>& s) const;
+
+        // Looks for improving columns with greedy constructions followed by local search,
+        // seeded with the heaviest vertices, possibly using multiple threads.
+        std::vector<StableSet> solve_heuristically(const MpSolution& mpsol, const std::vector<float>& w, const std::vector<uint32_t>& order, float min_reduced_cost) const;
+
+        // Solves the pricing with the exact MWSS solver and adds variants of the optimal column.
+        // With params.pricing_early_exit, the MWSS solver stops at the first column whose reduced
+        // cost is above min_reduced_cost, and the solution is only optimal if there is none.
+        MwssSolution solve_exactly(const MpSolution& mpsol, const WeightMap& wm, const std::vector<float>& w, const std::vector<uint32_t>& order, float min_reduced_cost) const;
+
     public:
 
-        MwssSolver(const Graph& o, const Graph& g) : o{o}, g{g} {}
-        std::vector<StableSet> solve(const MpSolution& mpsol) const;
+        MwssSolver(const Graph& o, const Graph& g);
+        ~MwssSolver();
+
+        // Solves the pricing problem and returns up to params.pricing_max_columns columns.
+        // If enabled, the heuristic pricing is tried first and, if it finds any column with
+        // reduced cost above min_reduced_cost, the exact pricing is skipped. Otherwise, the
+        // exact pricing returns the optimal (or, with early exit, the first improving) column
+        // first, followed by greedy variants whose reduced cost is above min_reduced_cost.
+        MwssSolution solve(const MpSolution& mpsol, float min_reduced_cost) const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,47 +1,29 @@
 #include "sewell_mwss_solver.hpp"
-#include "../utils/console_output.hpp"
 #include "../utils/dbg_output.hpp"
 
+#include <cmath>
 #include <numeric>
 
 namespace sgcp {
-    SewellMwssSolver::SewellMwssSolver(const Graph& o, const Graph& g, WeightMap w) : o{o}, g{g}, w{w} {
-        assert(w.size() == g.n_vertices);
-        calculate_int_weights(w);
-    }
-
-    boost::optional<StableSet> SewellMwssSolver::solve() const {
-        MWSSgraph m_graph;
-        MWSSdata m_data;
-        wstable_info m_info;
-        wstable_parameters m_params;
-
-        auto m_weight_lower_bound = multiplier;
-        auto m_weight_goal = MWISNW_MAX;
-
-        int m_graph_allocated = 0, m_initialised = 0, m_called = 0;
-
-        boost::optional<StableSet> s;
-
+    SewellMwssSolver::SewellMwssSolver(const Graph& o, const Graph& g) : o{o}, g{g}, multiplier{o.params.mwss_multiplier}, initialised{false} {
         reset_pointers(&m_graph, &m_data, &m_info);
         default_parameters(&m_params);
 
-        m_graph_allocated = allocate_graph(&m_graph, g.n_vertices);
-        MWIScheck_rval(m_graph_allocated, "Cannot allocate m_graph");
+        // The library prints its own information only if asked to.
+        m_params.prn_info = 0;
+
+        if(allocate_graph(&m_graph, g.n_vertices) != 0) {
+            std::cerr << "Cannot allocate m_graph" << std::endl;
+            return;
+        }
 
         m_graph.n_nodes = g.n_vertices;
 
         for(auto i = 1; i <= m_graph.n_nodes; i++) {
-            m_graph.weight[i] = int_weights.at(i - 1);
+            m_graph.weight[i] = 0;
             for(auto j = 1; j <= m_graph.n_nodes; j++) { m_graph.adj[i][j] = 0; }
         }
 
-        assert(std::all_of(
-            &m_graph.weight[1],
-            &m_graph.weight[m_graph.n_nodes],
-            [] (auto weight) { return weight >= 0; }
-        ));
-
         for(auto eit = edges(g.g); eit.first != eit.second; ++eit.first) {
             auto source_id = g.g[source(*eit.first, g.g)].id + 1;
             auto target_id = g.g[target(*eit.first, g.g)].id + 1;
@@ -64,27 +46,44 @@ namespace sgcp {
         // Checks consistency of the internal variables of m_graph
         assert(check_graph(&m_graph) == 1);
 
-        SUPPRESS_OUTPUT(m_initialised = initialize_max_wstable(&m_graph, &m_info);)
-        
-        MWIScheck_rval(m_initialised, "Cannot initialise max wstable");
+        if(initialize_max_wstable(&m_graph, &m_info) != 0) {
+            std::cerr << "Cannot initialise max wstable" << std::endl;
+            return;
+        }
+
+        initialised = true;
+    }
+
+    SewellMwssSolver::~SewellMwssSolver() {
+        free_max_wstable(&m_graph, &m_data, &m_info);
+    }
+
+    boost::optional<StableSet> SewellMwssSolver::solve(const WeightMap& w, float lower_bound, float goal) const {
+        if(!initialised) { return boost::none; }
+
+        assert(w.size() == g.n_vertices);
+
+        auto int_weights = calculate_int_weights(w);
 
-        SUPPRESS_OUTPUT(m_called = call_max_wstable(&m_graph, &m_data, &m_params, &m_info, m_weight_goal, m_weight_lower_bound);)
+        for(auto i = 1; i <= m_graph.n_nodes; i++) { m_graph.weight[i] = int_weights[i - 1]; }
 
-        if(m_called != 0) {
-            free_max_wstable(&m_graph, &m_data, &m_info);
+        auto m_weight_lower_bound = static_cast<MWISNW>(multiplier * lower_bound);
+        MWISNW m_weight_goal = MWISNW_MAX;
+
+        if(static_cast<double>(multiplier) * goal < static_cast<double>(MWISNW_MAX)) {
+            m_weight_goal = static_cast<MWISNW>(std::ceil(multiplier * goal));
+        }
+
+        if(call_max_wstable(&m_graph, &m_data, &m_params, &m_info, m_weight_goal, m_weight_lower_bound) != 0) {
             return boost::none;
         }
 
         // DEBUG_ONLY(std::cout << "Sewell MWSS Solution: " << static_cast<float>(m_data.best_z) / static_cast<float>(multiplier) << std::endl;)
 
-        s = make_stable_set(m_data);
-
-        CLEANUP: free_max_wstable(&m_graph, &m_data, &m_info);
-
-        return s;
+        return make_stable_set();
     }
 
-    StableSet SewellMwssSolver::make_stable_set(const MWSSdata& m_data) const {
+    StableSet SewellMwssSolver::make_stable_set() const {
         VertexIdSet s;
 
         for(auto i = 1; i <= m_data.n_best; i++) {
@@ -98,7 +97,7 @@ namespace sgcp {
         return StableSet{o, s};
     }
 
-    void SewellMwssSolver::calculate_int_weights(const WeightMap& w) {
+    std::vector<uint32_t> SewellMwssSolver::calculate_int_weights(const WeightMap& w) const {
         std::vector<uint32_t> vertices_id(w.size());
         std::transform(w.begin(), w.end(), vertices_id.begin(), [] (auto kv) { return kv.first; });
         std::sort(vertices_id.begin(), vertices_id.end());
@@ -108,9 +107,7 @@ namespace sgcp {
 
         assert(vertices_id == vertices_id_check);
 
-        multiplier = o.params.mwss_multiplier;
-
-        int_weights = std::vector<uint32_t>(w.size());
+        auto int_weights = std::vector<uint32_t>(w.size());
         std::transform(vertices_id.begin(), vertices_id.end(), int_weights.begin(), [&] (auto i) { return multiplier * w.at(i); });
 
         assert(std::all_of(
@@ -118,5 +115,7 @@ namespace sgcp {
             int_weights.end(),
             [] (auto weight) { return weight < std::numeric_limits<int>::max(); }
         ));
+
+        return int_weights;
     }
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include "../graph.hpp"
 #include "../stable_set.hpp"
 
+#include <limits>
 #include <vector>
 #include <boost/optional.hpp>
 
@@ -13,30 +14,44 @@ extern "C" {
 }
 
 namespace sgcp {
+    // Wraps the Sewell algorithm's data structures. They are built once for a
+    // graph, in the constructor, and are then reused by every call to solve,
+    // which only needs to update the vertex weights.
     class SewellMwssSolver {
         // Original graph, before any branching rules modified it
         const Graph& o;
         
         const Graph& g;
-        
-        WeightMap w;
 
-        std::vector<uint32_t> int_weights;
         uint32_t multiplier;
 
+        mutable MWSSgraph m_graph;
+        mutable MWSSdata m_data;
+        mutable wstable_info m_info;
+        mutable wstable_parameters m_params;
+
+        // Tells whether the data structures have been successfully built.
+        bool initialised;
+
         static constexpr float eps = 1e-6;
 
-        void calculate_int_weights(const WeightMap& w);
-        StableSet make_stable_set(const MWSSdata& m_data) const;
+        std::vector<uint32_t> calculate_int_weights(const WeightMap& w) const;
+        StableSet make_stable_set() const;
 
     public:
-        SewellMwssSolver(const Graph& o, const Graph& g, WeightMap w);
+        SewellMwssSolver(const Graph& o, const Graph& g);
+        ~SewellMwssSolver();
+
+        SewellMwssSolver(const SewellMwssSolver&) = delete;
+        SewellMwssSolver& operator=(const SewellMwssSolver&) = delete;
 
         // Solves the Maximum Weight Stable Set problem on the graph, with
         // the given weights, using the Sewell algorithm, incldued in the
-        // Exactcolors package by Stephan Held.
-        boost::optional<StableSet> solve() const;
+        // Exactcolors package by Stephan Held. Only stable sets heavier than
+        // lower_bound are considered, and the search stops as soon as it finds
+        // one whose weight is at least goal.
+        boost::optional<StableSet> solve(const WeightMap& w, float lower_bound = 1.0f, float goal = std::numeric_limits<float>::max()) const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,6 +3,9 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
+#include <cassert>
+#include <iostream>
+
 namespace sgcp {
     Params::Params(std::string filename) {
         using namespace boost::property_tree;
@@ -12,10 +15,14 @@ namespace sgcp {
 
         time_limit = tree.get<uint32_t>("branch_and_price.time_limit");
         cplex_threads = tree.get<uint32_t>("branch_and_price.cplex_threads");
+        bb_threads = tree.get<uint32_t>("branch_and_price.threads");
         mp_time_limit = tree.get<uint32_t>("branch_and_price.mp_time_limit");
 
         use_initial_solution = tree.get<bool>("branch_and_price.use_initial_solution");
         use_populate = tree.get<bool>("branch_and_price.use_populate");
+        bb_early_node_termination = tree.get<bool>("branch_and_price.early_node_termination");
+        checkpoint_active = tree.get<bool>("branch_and_price.checkpoint.active");
+        checkpoint_every_n_nodes = tree.get<uint32_t>("branch_and_price.checkpoint.every_n_nodes");
 
         mip_heur_active = tree.get<bool>("branch_and_price.mip_heuristic.active");
         mip_heur_alns = tree.get<bool>("branch_and_price.mip_heuristic.alns");
@@ -24,6 +31,28 @@ namespace sgcp {
         mip_heur_max_cols = tree.get<uint32_t>("branch_and_price.mip_heuristic.max_cols");
         mip_heur_frequency = tree.get<uint32_t>("branch_and_price.mip_heuristic.frequency");
 
+        pricing_max_columns = tree.get<uint32_t>("branch_and_price.pricing.max_columns");
+        pricing_exact_solver = tree.get<std::string>("branch_and_price.pricing.exact_solver");
+        assert(pricing_exact_solver == "sewell" || pricing_exact_solver == "bitset");
+
+        // Sewell's code is not known to be reentrant, so tree threads must not price with it at once.
+        if(bb_threads > 1u && pricing_exact_solver == "sewell") {
+            std::cerr << "Warning: pricing with the bitset MWSS solver instead of Sewell's, which may not be reentrant, "
+                      << "as branch-and-price uses " << bb_threads << " threads" << std::endl;
+            pricing_exact_solver = "bitset";
+        }
+
+        pricing_early_exit = tree.get<bool>("branch_and_price.pricing.early_exit");
+        pricing_reduce_graph = tree.get<bool>("branch_and_price.pricing.reduce_graph");
+        pricing_heuristic = tree.get<bool>("branch_and_price.pricing.heuristic.active");
+        pricing_heuristic_seeds = tree.get<uint32_t>("branch_and_price.pricing.heuristic.seeds");
+        pricing_heuristic_threads = tree.get<uint32_t>("branch_and_price.pricing.heuristic.threads");
+
+        stabilisation_method = tree.get<std::string>("branch_and_price.stabilisation.method");
+        assert(stabilisation_method == "none" || stabilisation_method == "wentges");
+        stabilisation_alpha = tree.get<float>("branch_and_price.stabilisation.alpha");
+        assert(stabilisation_alpha >= 0.0f && stabilisation_alpha < 1.0f);
+
         mwss_multiplier = tree.get<uint32_t>("mwss_multiplier");
 
         tabu_iterations = tree.get<uint32_t>("tabu.iterations");
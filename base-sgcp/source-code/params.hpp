@@ -13,12 +13,16 @@ namespace sgcp {
     struct Params {
         uint32_t time_limit;
         uint32_t cplex_threads;
+        uint32_t bb_threads;
         uint32_t mp_time_limit;
 
         BBExplorationStrategy bb_exploration_strategy;
 
         bool use_initial_solution;
         bool use_populate;
+        bool bb_early_node_termination;
+        bool checkpoint_active;
+        uint32_t checkpoint_every_n_nodes;
 
         bool mip_heur_active;
         bool mip_heur_alns;
@@ -27,6 +31,17 @@ namespace sgcp {
         uint32_t mip_heur_max_cols;
         uint32_t mip_heur_frequency;
 
+        uint32_t pricing_max_columns;
+        std::string pricing_exact_solver;
+        bool pricing_early_exit;
+        bool pricing_reduce_graph;
+        bool pricing_heuristic;
+        uint32_t pricing_heuristic_seeds;
+        uint32_t pricing_heuristic_threads;
+
+        std::string stabilisation_method;
+        float stabilisation_alpha;
+
         uint32_t mwss_multiplier;
 
         uint32_t tabu_iterations;
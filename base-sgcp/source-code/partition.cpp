@@ -0,0 +1,54 @@
+#include "partition.hpp"
+
+namespace sgcp {
+    Partition::Partition(std::vector<uint32_t> offsets, std::vector<uint32_t> elements) : offsets{std::move(offsets)}, elements{std::move(elements)} {
+        assert(!this->offsets.empty() && this->offsets.front() == 0u && this->offsets.back() == this->elements.size());
+        for(auto k = 0u; k < size(); k++) { index_cluster(k); }
+    }
+
+    void Partition::index_cluster(uint32_t k) {
+        for(auto id : (*this)[k]) {
+            if(id >= part_of.size()) { part_of.resize(id + 1u, none); }
+            if(part_of[id] == none) { part_of[id] = k; }
+        }
+    }
+
+    void Partition::erase_vertex(uint32_t id) {
+        auto k = partition_of(id);
+        assert(k != none);
+
+        auto it = std::find(elements.begin() + offsets[k], elements.begin() + offsets[k + 1u], id);
+        assert(it != elements.begin() + offsets[k + 1u]);
+
+        elements.erase(it);
+        for(auto j = k + 1u; j < offsets.size(); j++) { offsets[j]--; }
+        part_of[id] = none;
+    }
+
+    void Partition::erase_clusters(const std::vector<uint32_t>& ks) {
+        std::vector<bool> erase(size(), false);
+        for(auto k : ks) { erase[k] = true; }
+
+        Partition new_p;
+        new_p.reserve(size(), elements.size());
+
+        for(auto k = 0u; k < size(); k++) {
+            if(!erase[k]) { new_p.push_back((*this)[k]); }
+        }
+
+        *this = std::move(new_p);
+    }
+
+    void Partition::renumber(const std::vector<uint32_t>& new_id) {
+        for(auto& id : elements) {
+            assert(id < new_id.size());
+            id = new_id[id];
+        }
+
+        part_of.clear();
+        for(auto k = 0u; k < size(); k++) {
+            std::sort(elements.begin() + offsets[k], elements.begin() + offsets[k + 1u]);
+            index_cluster(k);
+        }
+    }
+}
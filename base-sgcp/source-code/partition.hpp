@@ -0,0 +1,95 @@
+#ifndef _PARTITION_HPP
+#define _PARTITION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace sgcp {
+    // Partition of the vertex ids into clusters, stored CSR-style: the ids of all
+    // clusters live in one contiguous array, with cluster k occupying positions
+    // offsets[k], ..., offsets[k + 1] - 1 (sorted by id). A dense vertex -> cluster
+    // array answers partition_of() with a single load.
+    class Partition {
+    public:
+        // Read-only view over the (sorted) vertex ids of one cluster.
+        class Set {
+            const uint32_t* first;
+            const uint32_t* last;
+
+        public:
+            using const_iterator = const uint32_t*;
+
+            Set(const uint32_t* first, const uint32_t* last) : first{first}, last{last} {}
+
+            const uint32_t* begin() const { return first; }
+            const uint32_t* end() const { return last; }
+            uint32_t size() const { return static_cast<uint32_t>(last - first); }
+            bool empty() const { return first == last; }
+            bool contains(uint32_t id) const { return std::binary_search(first, last, id); }
+
+            // Same as std::unordered_set::find, so that the view can replace it.
+            const uint32_t* find(uint32_t id) const {
+                auto it = std::lower_bound(first, last, id);
+                return (it != last && *it == id) ? it : last;
+            }
+        };
+
+        // Value stored by partition_of() for ids which are in no cluster.
+        static constexpr uint32_t none = static_cast<uint32_t>(-1);
+
+    private:
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> elements;
+        std::vector<uint32_t> part_of;
+
+        void index_cluster(uint32_t k);
+
+    public:
+        Partition() : offsets{0u} {}
+
+        // Builds a partition straight from its CSR arrays (each cluster sorted by id).
+        Partition(std::vector<uint32_t> offsets, std::vector<uint32_t> elements);
+
+        // Number of clusters.
+        uint32_t size() const { return static_cast<uint32_t>(offsets.size() - 1u); }
+        bool empty() const { return size() == 0u; }
+
+        Set operator[](uint32_t k) const { assert(k < size()); return Set{elements.data() + offsets[k], elements.data() + offsets[k + 1u]}; }
+        Set at(uint32_t k) const { assert(k < size()); return (*this)[k]; }
+
+        // Returns the cluster containing the vertex with the given id, or Partition::none.
+        // If clusters overlap, the one with the lowest index is returned.
+        uint32_t partition_of(uint32_t id) const { return id < part_of.size() ? part_of[id] : none; }
+
+        // Appends a new cluster, made of the ids in the given container.
+        template<typename Container>
+        void push_back(const Container& s) {
+            elements.insert(elements.end(), s.begin(), s.end());
+            std::sort(elements.begin() + offsets.back(), elements.end());
+            offsets.push_back(static_cast<uint32_t>(elements.size()));
+            index_cluster(size() - 1u);
+        }
+
+        // The CSR arrays, e.g. to save the partition.
+        const std::vector<uint32_t>& cluster_offsets() const { return offsets; }
+        const std::vector<uint32_t>& cluster_elements() const { return elements; }
+
+        void reserve(uint32_t n_clusters, uint32_t n_elements) {
+            offsets.reserve(n_clusters + 1u);
+            elements.reserve(n_elements);
+        }
+
+        // Removes a vertex id from the cluster which contains it.
+        void erase_vertex(uint32_t id);
+
+        // Drops the given clusters (their vertices included) and renumbers the remaining ones.
+        void erase_clusters(const std::vector<uint32_t>& ks);
+
+        // Replaces each id i with new_id[i].
+        void renumber(const std::vector<uint32_t>& new_id);
+    };
+}
+
+#endif
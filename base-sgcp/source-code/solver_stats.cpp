@@ -1,5 +1,7 @@
 #include "solver_stats.hpp"
+#include "utils/binary_io.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <numeric>
 #include <cmath>
@@ -24,6 +26,9 @@ namespace sgcp {
         n_branch_on_edge = 0u;
         col_generated_by_pricing_at_root = 0u;
         column_pool_size = 0u;
+        n_mispricings = 0u;
+        n_cg_iterations = 0u;
+        n_early_terminations = 0u;
 
         density = 0.0f;
         avg_partition_size = 0.0f;
@@ -84,6 +89,43 @@ namespace sgcp {
         instance = instance.substr(0, instance.find_last_of("."));
     }
 
+    void SolverStats::write_binary(std::ostream& out) const {
+        using namespace binary_io;
+
+        for(auto v : {  nodes_solved, nodes_open, max_depth_explored, n_branch_on_coloured_v, n_branch_on_edge,
+                        col_generated_by_pricing_at_root, column_pool_size, n_mispricings, n_cg_iterations,
+                        n_early_terminations }) { write(out, v); }
+
+        for(auto v : {  heuristic_ub, ub_after_root_pricing, lb_after_root_pricing, ub_after_root_overall,
+                        tot_computing_time, root_node_time, tot_lp_time, tot_pricing_time }) { write(out, v); }
+
+        write_vector(out, num_pri_cols);
+    }
+
+    void SolverStats::read_binary(std::istream& in) {
+        using namespace binary_io;
+
+        for(auto* v : { &nodes_solved, &nodes_open, &max_depth_explored, &n_branch_on_coloured_v, &n_branch_on_edge,
+                        &col_generated_by_pricing_at_root, &column_pool_size, &n_mispricings, &n_cg_iterations,
+                        &n_early_terminations }) { *v = read<uint32_t>(in); }
+
+        for(auto* v : { &heuristic_ub, &ub_after_root_pricing, &lb_after_root_pricing, &ub_after_root_overall,
+                        &tot_computing_time, &root_node_time, &tot_lp_time, &tot_pricing_time }) { *v = read<float>(in); }
+
+        num_pri_cols = read_vector<uint32_t>(in);
+    }
+
+    void SolverStats::merge_worker(const SolverStats& worker) {
+        // Workers run in parallel, so the elapsed time is the one of the slowest.
+        tot_computing_time = std::max(tot_computing_time, worker.tot_computing_time);
+        tot_lp_time += worker.tot_lp_time;
+        tot_pricing_time += worker.tot_pricing_time;
+        n_mispricings += worker.n_mispricings;
+        n_cg_iterations += worker.n_cg_iterations;
+        n_early_terminations += worker.n_early_terminations;
+        num_pri_cols.insert(num_pri_cols.end(), worker.num_pri_cols.begin(), worker.num_pri_cols.end());
+    }
+
     void SolverStats::write_csv() const {
         // If boost::filesystem worked decently on OS X:
         // boost::filesystem::path dir(params.results_dir);
@@ -116,7 +158,10 @@ namespace sgcp {
         f << gap_after_root_overall << ",";
         f << gap << ",";
         f << tot_computing_time << ",";
-        f << root_node_time << std::endl;
+        f << root_node_time << ",";
+        f << n_mispricings << ",";
+        f << n_cg_iterations << ",";
+        f << n_early_terminations << std::endl;
 
         f.close();
     }
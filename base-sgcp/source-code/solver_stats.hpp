@@ -4,6 +4,8 @@
 #include "params.hpp"
 #include "graph.hpp"
 
+#include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -21,6 +23,9 @@ namespace sgcp {
         uint32_t n_branch_on_edge;
         uint32_t col_generated_by_pricing_at_root;
         uint32_t column_pool_size;
+        uint32_t n_mispricings;
+        uint32_t n_cg_iterations;
+        uint32_t n_early_terminations;
 
         float density;
         float avg_partition_size;
@@ -49,6 +54,15 @@ namespace sgcp {
         void read_instance_data(const Graph& g);
         void build_stats();
         void write_csv() const;
+
+        // Saves and restores the statistics collected while solving, in binary form,
+        // for checkpoints. The instance data and the derived statistics are not included.
+        void write_binary(std::ostream& out) const;
+        void read_binary(std::istream& in);
+
+        // Adds the statistics collected by a worker thread of the branch-and-price tree,
+        // which started from this object's computing time.
+        void merge_worker(const SolverStats& worker);
     };
 }
 
@@ -1,9 +1,20 @@
 #include "stable_set.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace sgcp {
-    StableSet::StableSet(const Graph& g) : g{g}, intersects_partition{g.n_partitions}, s{}, dummy{true} {
-        for(auto v = 0u; v < g.n_vertices; v++) { s.insert(v); }
-        for(auto k = 0u; k < g.n_partitions; k++) { intersects_partition[k] = true; }
+    StableSet::StableSet(const Graph& g) : g{g}, vertices{g.n_vertices}, intersects_partition{g.n_partitions}, s(g.n_vertices), dummy{true} {
+        std::iota(s.begin(), s.end(), 0u);
+        for(auto v = 0u; v < g.n_vertices; v++) { vertices.set(v); }
+        for(auto k = 0u; k < g.n_partitions; k++) { intersects_partition.set(k); }
+    }
+
+    StableSet::StableSet(const Graph& g, std::vector<uint32_t> sv) : g{g}, vertices{g.n_vertices}, intersects_partition{g.n_partitions}, s{std::move(sv)}, dummy{false} {
+        std::sort(s.begin(), s.end());
+        s.erase(std::unique(s.begin(), s.end()), s.end());
+        assert(is_valid(true));
+        create_bitsets();
     }
 
     bool StableSet::is_valid(bool print_details) const {
@@ -28,7 +39,7 @@ namespace sgcp {
                     return false;
                 }
 
-                if(edge(*vi, *vj, g.get().g).second) {
+                if(g.get().connected(*outer_it, *inner_it)) {
                     if(print_details) {
                         std::cerr << "Vertices " << *outer_it << " and " << *inner_it << " are in the same stable set, but are connected by an edge!" << std::endl;
                     }
@@ -40,83 +51,45 @@ namespace sgcp {
         return true;
     }
 
-    void StableSet::create_bitset() {
-        for(auto k = 0u; k < g.get().n_partitions; k++) {
-            intersects_partition[k] = intersects(g.get().p[k]);
+    void StableSet::create_bitsets() {
+        for(auto id : s) {
+            vertices.set(id);
+            intersects_partition.set(g.get().partition_for(id));
         }
     }
 
-    bool StableSet::intersects(const std::unordered_set<uint32_t>& p) const {
-        // The dummy set intersects everything! :-)
-        // Therefore, we short-circuit the check.
-        if(dummy) { return true; }
+    void StableSet::add_vertex(uint32_t id) {
+        auto it = std::lower_bound(s.begin(), s.end(), id);
+        if(it != s.end() && *it == id) { return; }
 
-        return std::any_of(
-            s.begin(),
-            s.end(),
-            [&] (uint32_t i) -> bool {
-                return std::find(p.begin(), p.end(), i) != p.end();
-            }
-        );
+        s.insert(it, id);
+        vertices.set(id);
+        intersects_partition.set(g.get().partition_for(id));
     }
 
-    bool StableSet::intersects(uint32_t k) const {
-        return intersects_partition[k];
-    }
+    void StableSet::remove_vertex(uint32_t id) {
+        auto it = std::lower_bound(s.begin(), s.end(), id);
+        if(it == s.end() || *it != id) { return; }
 
-    uint32_t StableSet::any_common_vertex(const std::unordered_set<uint32_t>& p) const {
-        auto it = std::find_if(
-            s.begin(),
-            s.end(),
-            [&] (uint32_t i) -> bool {
-                return std::find(p.begin(), p.end(), i) != p.end();
-            }
-        );
+        s.erase(it);
+        vertices.reset(id);
 
-        assert(it != s.end());
-        return *it;
-    }
-
-    uint32_t StableSet::any_common_vertex(uint32_t k) const {
-        return any_common_vertex(g.get().p[k]);
+        // The partition is still intersected if any other of its vertices is in the set.
+        auto k = g.get().partition_for(id);
+        const auto& p = g.get().p[k];
+        if(std::none_of(p.begin(), p.end(), [&] (uint32_t w_id) { return vertices.test(w_id); })) {
+            intersects_partition.reset(k);
+        }
     }
 
     float StableSet::reduced_cost(const std::vector<float>& duals) const {
-        float cost = 0;
-
-        for(auto k = 0u; k < g.get().n_partitions; k++) {
-            if(intersects(g.get().p[k])) { cost += duals.at(k); }
-        }
+        assert(duals.size() >= intersects_partition.size());
 
+        float cost = 0;
+        intersects_partition.for_each([&] (uint32_t k) { cost += duals[k]; });
         return cost;
     }
 
-    bool operator<(const StableSet& lhs, const StableSet& rhs) {
-        auto it1 = lhs.s.begin(), it2 = rhs.s.begin();
-
-        while(it1 != lhs.s.end()) {
-            if(it2 == rhs.s.end() || *it2 < *it1) { return false; }
-            else if (*it1 < *it2 ) { return true; }
-            ++it1; ++it2;
-        }
-
-        return it2 != rhs.s.end();
-    }
-
-    bool operator==(const StableSet& lhs, const StableSet& rhs) {
-        if(lhs.s.size() != rhs.s.size()) { return false; }
-
-        auto it1 = lhs.s.begin(), it2 = rhs.s.begin();
-        while(it1 != lhs.s.end()) {
-            if(*it1 != *it2) { return false; }
-            ++it1; ++it2;
-        }
-
-        assert(it2 == rhs.s.end());
-
-        return true;
-    }
-
     std::ostream& operator<<(std::ostream& out, const StableSet& s) {
         out << "{ ";
         for(const auto& v : s.s) { out << v << " "; }
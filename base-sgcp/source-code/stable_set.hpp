@@ -2,13 +2,13 @@
 #define _STABLE_SET_HPP
 
 #include "graph.hpp"
+#include "bitset.hpp"
 
 #include <functional>
 
 #include <vector>
 #include <set>
 #include <map>
-#include <boost/dynamic_bitset.hpp>
 
 namespace sgcp {
     class StableSet;
@@ -16,8 +16,16 @@ namespace sgcp {
 
     class StableSet {
         std::reference_wrapper<const Graph> g;
-        boost::dynamic_bitset<> intersects_partition;
-        VertexIdSet s;
+
+        // Vertices in the set, as a bitset indexed by vertex id.
+        Bitset vertices;
+
+        // Partitions intersected by the set, as a bitset indexed by partition id.
+        // It is kept up to date by add_vertex and remove_vertex.
+        Bitset intersects_partition;
+
+        // Vertices in the set, as a sorted list of vertex ids.
+        std::vector<uint32_t> s;
 
     public:
 
@@ -27,15 +35,8 @@ namespace sgcp {
 
     private:
 
-        // Creates a bitset of which partitions are intersected by the set.
-        void create_bitset();
-
-        // Tells wether a stable set intersects a partition.
-        bool intersects(const std::unordered_set<uint32_t>& p) const;
-
-        // Gives the vertex id of any vertex of the stable set that is in the given partition (by partition or partition id).
-        uint32_t any_common_vertex(const std::unordered_set<uint32_t>& p) const;
-        uint32_t any_common_vertex(uint32_t k) const;
+        // Fills the vertex and partition bitsets from the list of vertex ids.
+        void create_bitsets();
 
     public:
 
@@ -43,40 +44,51 @@ namespace sgcp {
         StableSet(const Graph& g);
 
         // Creates a (valid) stable set out of a vertex set.
-        StableSet(const Graph& g, VertexIdSet s) : g{g}, intersects_partition{g.n_partitions}, s{s}, dummy{false} { assert(is_valid(true)); create_bitset(); }
+        StableSet(const Graph& g, const VertexIdSet& s) : StableSet(g, std::vector<uint32_t>(s.begin(), s.end())) {}
 
         // Creates a (valid) stable set out of a list of vector ids.
-        StableSet(const Graph& g, std::vector<uint32_t> sv) : g{g}, intersects_partition{g.n_partitions}, s{sv.begin(), sv.end()}, dummy{false} { assert(is_valid(true)); create_bitset(); }
+        StableSet(const Graph& g, std::vector<uint32_t> sv);
+
+        // Returns the underlying vertex ids, sorted.
+        const std::vector<uint32_t>& get_set() const { return s; }
 
-        // Returns the underlying set of vertex ids.
-        const VertexIdSet& get_set() const { return s; }
+        // Returns the bitset of the vertices in the set.
+        const Bitset& get_vertices() const { return vertices; }
+
+        // Returns the bitset of the partitions intersected by the set.
+        const Bitset& get_partitions() const { return intersects_partition; }
 
         // Tells the size of the underlying vertex id set.
         uint32_t size() const { return s.size(); }
 
-        // Adds a vertex to the set and recomputes the bitset.
-        void add_vertex(uint32_t id) { s.insert(id); create_bitset(); }
+        // Adds a vertex to the set and marks its partition as intersected.
+        void add_vertex(uint32_t id);
 
-        // Remove a vertex to the set and recomputes the bitset.
-        void remove_vertex(uint32_t id) { s.erase(id); create_bitset(); }
+        // Removes a vertex from the set and, if no other vertex of its partition
+        // is left, marks the partition as not intersected.
+        void remove_vertex(uint32_t id);
 
         // Tells wether a stable set intersects a partition (by partition id).
-        bool intersects(uint32_t k) const;
+        bool intersects(uint32_t k) const { return intersects_partition.test(k); }
 
         // Checks that s actually defines a stable set of the graph.
         bool is_valid(bool print_details) const;
 
         // Checks if the stable set has a vertex with a specific id.
-        bool has_vertex(uint32_t id) const { return s.find(id) != s.cend(); }
+        bool has_vertex(uint32_t id) const { return id < vertices.size() && vertices.test(id); }
 
-        // Calculates the reduced cost of the stable set, given the duals.
+        // Calculates the reduced cost of the stable set, given the duals: it is the sum of
+        // the duals of the intersected partitions.
         float reduced_cost(const std::vector<float>& duals) const;
 
+        // Hash of the vertex set, consistent with operator==.
+        std::size_t hash() const { return vertices.hash(); }
+
         // Useful to use StableSet as key in sorted containers.
-        friend bool operator<(const StableSet& lhs, const StableSet& rhs);
+        friend bool operator<(const StableSet& lhs, const StableSet& rhs) { return lhs.vertices < rhs.vertices; }
 
         // Useful to prune duplicate columns
-        friend bool operator==(const StableSet& lhs, const StableSet& rhs);
+        friend bool operator==(const StableSet& lhs, const StableSet& rhs) { return lhs.vertices == rhs.vertices; }
 
         // Prints out the stable set.
         friend std::ostream& operator<<(std::ostream& out, const StableSet& s);
@@ -86,4 +98,10 @@ namespace sgcp {
     };
 }
 
+namespace std {
+    template<> struct hash<sgcp::StableSet> {
+        std::size_t operator()(const sgcp::StableSet& s) const { return s.hash(); }
+    };
+}
+
 #endif
@@ -0,0 +1,57 @@
+#ifndef _BINARY_IO_HPP
+#define _BINARY_IO_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sgcp {
+    namespace binary_io {
+        // Writes a value as its raw bytes (in the machine's byte order).
+        template<typename T>
+        void write(std::ostream& out, const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written as raw bytes");
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        // Writes the size of a vector, followed by its elements.
+        template<typename T>
+        void write_vector(std::ostream& out, const std::vector<T>& v) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written as raw bytes");
+            uint64_t size = v.size();
+            write(out, size);
+            if(size > 0u) { out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(size * sizeof(T))); }
+        }
+
+        // Writes the elements of a vector, without its size.
+        template<typename T>
+        void write_array(std::ostream& out, const std::vector<T>& v) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written as raw bytes");
+            if(!v.empty()) { out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T))); }
+        }
+
+        template<typename T>
+        T read(std::istream& in) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read as raw bytes");
+            T value;
+            in.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if(!in) { throw std::runtime_error("Unexpected end of binary file"); }
+            return value;
+        }
+
+        template<typename T>
+        std::vector<T> read_vector(std::istream& in) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read as raw bytes");
+            auto size = read<uint64_t>(in);
+            std::vector<T> v(size);
+            if(size > 0u) { in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(size * sizeof(T))); }
+            if(!in) { throw std::runtime_error("Unexpected end of binary file"); }
+            return v;
+        }
+    }
+}
+
+#endif
@@ -3,164 +3,499 @@
 //
 
 #include "cache.hpp"
-#include "stream_utils.hpp"
+#include "mapped_file.hpp"
 #include "string_utils.hpp"
+
+#include <sys/file.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <fstream>
-#include <cstdio>
-#include <iterator>
 
 namespace sgcp {
     namespace cache {
-        static const csv_filenames bks_cf{"bks.csv", "tmpbks.csv", "bks.bak"};
-        static const csv_filenames init_cf{"init.csv", "tmpinit.csv", "init.bak"};
+        static const store_filenames bks_sf{"bks.cache", "bks.journal", "bks.lock", "tmpbks.cache"};
+        static const store_filenames init_sf{"init.cache", "init.journal", "init.lock", "tmpinit.cache"};
+
+        // Layout of a store file:
+        //   Header
+        //   Slot[n_slots]        (key == 0 marks an empty slot)
+        //   Entry...
+        // Layout of a journal file:
+        //   journal_magic
+        //   Entry...
+        // An entry is an EntryHeader, followed by the number of vertices of each
+        // colour and then by the vertex ids of all the colours, padded to a
+        // multiple of 8 bytes.
+        static const char store_magic[8] = {'S', 'G', 'C', 'P', 'C', 'A', 'C', '2'};
+        static const char journal_magic[8] = {'S', 'G', 'C', 'P', 'J', 'R', 'N', '1'};
+        static constexpr uint64_t initial_slots = 1024u;
+
+        // Past this size, the journal is merged into the store.
+        static constexpr uint64_t journal_max_size = 256u * 1024u;
+
+        struct Header {
+            char magic[8];
+            uint64_t n_slots;
+            uint64_t n_used;
+            uint64_t reserved;
+        };
+
+        struct Slot {
+            uint64_t key;
+            uint64_t offset;
+        };
+
+        struct EntryHeader {
+            uint64_t key;
+            uint32_t n_vertices;
+            uint32_t n_edges;
+            uint32_t n_partitions;
+            uint32_t n_colours;
+            uint32_t n_ids;
+            uint32_t checksum;
+        };
+
+        // Position of a valid entry in a mapped store or journal.
+        struct EntryRef {
+            const MappedFile* file;
+            uint64_t offset;
+            EntryHeader header;
+        };
+
+        // Exclusive advisory lock on a file, held for the lifetime of the object.
+        // The kernel releases it if the process dies.
+        class CacheLock {
+            int fd;
+
+        public:
+            explicit CacheLock(const char* filename) : fd{::open(filename, O_RDWR | O_CREAT, 0644)} {
+                if(fd < 0) { throw std::runtime_error("Cannot open the solution cache lock"); }
+                if(::flock(fd, LOCK_EX) != 0) {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot lock the solution cache");
+                }
+            }
+
+            ~CacheLock() { ::close(fd); }
+
+            CacheLock(const CacheLock&) = delete;
+            CacheLock& operator=(const CacheLock&) = delete;
+        };
+
+        static uint64_t mix(uint64_t h, uint64_t x) {
+            h ^= x + 0x9e3779b97f4a7c15ull;
+            h ^= h >> 30u; h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 27u; h *= 0x94d049bb133111ebull;
+            h ^= h >> 31u;
+            return h;
+        }
+
+        uint64_t instance_key(const Graph& g) {
+            uint64_t h = mix(mix(mix(0u, g.n_vertices), g.n_edges), g.n_partitions);
+
+            for(auto k = 0u; k < g.n_partitions; ++k) {
+                h = mix(h, g.p[k].size());
+                for(auto i : g.p[k]) { h = mix(h, i); }
+            }
 
-        bool is_same_file(const std::string s1, const std::string s2) {
-            // Do not try this at home!
-            auto path1 = string_utils::split(s1, '/');
-            auto path2 = string_utils::split(s2, '/');
+            for(auto i = 0u; i < g.n_vertices; ++i) {
+                const auto* row = g.adj.row(i);
+                for(auto w = 0u; w < g.adj.n_words(); ++w) { h = mix(h, row[w]); }
+            }
 
-            return path1.back() == path2.back();
+            // Key 0 is reserved for empty slots.
+            return h == 0u ? 1u : h;
         }
 
-        bool index_exists(const csv_filenames& cf) {
-            struct stat _;
-            return stat(cf.index, &_) == 0;
+        static uint64_t padded(uint64_t n_bytes) {
+            return (n_bytes + 7u) & ~uint64_t{7u};
         }
 
-        void create_index(const csv_filenames& cf) {
-            std::ofstream{cf.index};
+        static uint64_t entry_size(const EntryHeader& e) {
+            return padded(sizeof(EntryHeader) + (static_cast<uint64_t>(e.n_colours) + e.n_ids) * sizeof(uint32_t));
         }
 
-        void update_pool(const csv_filenames& cf, ColumnPool& pool, const Graph& g) {
-            if(!index_exists(cf)) { return; }
+        // Checksum of an entry (with its checksum field set to zero). Lets readers
+        // tell a complete journal entry from one which is still being written.
+        static uint32_t entry_checksum(const char* entry, const EntryHeader& e) {
+            auto h = mix(mix(mix(e.key, e.n_vertices), e.n_edges), e.n_partitions);
+            h = mix(mix(h, e.n_colours), e.n_ids);
 
-            std::ifstream idx{cf.index};
-            auto _ = stream_utils::remember_to_close(idx);
+            for(auto offset = sizeof(EntryHeader); offset < entry_size(e); offset += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, entry + offset, sizeof(word));
+                h = mix(h, word);
+            }
 
-            std::string line;
-            while(std::getline(idx, line)) {
-                auto tokens = string_utils::split(line, ';');
+            return static_cast<uint32_t>(h ^ (h >> 32u));
+        }
 
-                if(tokens.empty()) { continue; }
+        template<typename T>
+        static T load(const MappedFile& m, uint64_t offset) {
+            T value;
+            std::memcpy(&value, m.data() + offset, sizeof(T));
+            return value;
+        }
 
-                if(is_same_file(tokens[0], g.data_filename)) {
-                    assert(tokens.size() > 1u);
-                    std::stringstream ss;
+        static boost::optional<Header> read_header(const MappedFile& m) {
+            if(m.size() < sizeof(Header)) { return boost::none; }
 
-                    for(auto i = 1u; i < tokens.size(); ++i) {
-                        auto vertices = string_utils::split(tokens[i], ',');
+            auto h = load<Header>(m, 0u);
+            if(std::memcmp(h.magic, store_magic, sizeof(store_magic)) != 0) { return boost::none; }
+            if(h.n_slots == 0u || (h.n_slots & (h.n_slots - 1u)) != 0u) { return boost::none; }
+            if(sizeof(Header) + h.n_slots * sizeof(Slot) > m.size()) { return boost::none; }
 
-                        VertexIdSet vertexset{};
+            return h;
+        }
+
+        static uint64_t slot_offset(uint64_t slot) {
+            return sizeof(Header) + slot * sizeof(Slot);
+        }
 
-                        for(auto vstr : vertices) {
-                            ss.str(vstr);
-                            uint32_t v = 0u;
+        static boost::optional<EntryRef> read_entry_header(const MappedFile& m, uint64_t offset) {
+            if(offset + sizeof(EntryHeader) > m.size()) { return boost::none; }
 
-                            if(ss >> v) {
-                                vertexset.insert(v);
-                            }
+            auto e = load<EntryHeader>(m, offset);
+            if(offset + entry_size(e) > m.size()) { return boost::none; }
+            if(entry_checksum(m.data() + offset, e) != e.checksum) { return boost::none; }
 
-                            ss.clear();
-                        }
+            return EntryRef{&m, offset, e};
+        }
 
-                        assert(!vertexset.empty());
+        static bool matches(const EntryHeader& e, const Graph& g, uint64_t key) {
+            // Different instances with the same key are told apart by their size.
+            return e.key == key && e.n_vertices == g.n_vertices && e.n_edges == g.n_edges && e.n_partitions == g.n_partitions;
+        }
 
-                        StableSet stableset{g, vertexset};
-                        if(std::find(pool.begin(), pool.end(), stableset) == pool.end()) {
-                            pool.push_back(stableset);
-                        }
-                    }
+        static bool is_journal(const MappedFile& j) {
+            return j.size() >= sizeof(journal_magic) && std::memcmp(j.data(), journal_magic, sizeof(journal_magic)) == 0;
+        }
+
+        // Calls f(entry) for each complete entry of the journal, in the order they were appended,
+        // and returns the offset where the complete entries end.
+        template<typename F>
+        static uint64_t for_each_journal_entry(const MappedFile& j, F&& f) {
+            if(!is_journal(j)) { return 0u; }
+
+            uint64_t offset = sizeof(journal_magic);
+
+            while(auto e = read_entry_header(j, offset)) {
+                f(*e);
+                offset += entry_size(e->header);
+            }
+
+            return offset;
+        }
+
+        // Finds the entry for a key in the store, using its hash table.
+        static boost::optional<EntryRef> find_store_entry(const MappedFile& s, uint64_t key) {
+            auto h = read_header(s);
+            if(!h) { return boost::none; }
+
+            for(auto slot = key & (h->n_slots - 1u);; slot = (slot + 1u) & (h->n_slots - 1u)) {
+                auto sl = load<Slot>(s, slot_offset(slot));
+                if(sl.key == 0u) { return boost::none; }
+                if(sl.key == key) { return read_entry_header(s, sl.offset); }
+            }
+        }
+
+        // Finds the entry for the instance with the fewest colours, among the store and the journal.
+        static boost::optional<EntryRef> find_best_entry(const MappedFile& s, const MappedFile& j, const Graph& g, uint64_t key) {
+            auto best = find_store_entry(s, key);
+            if(best && !matches(best->header, g, key)) { best = boost::none; }
+
+            for_each_journal_entry(j, [&] (const EntryRef& e) {
+                if(matches(e.header, g, key) && (!best || e.header.n_colours < best->header.n_colours)) { best = e; }
+            });
+
+            return best;
+        }
+
+        static void write_all(int fd, const char* buf, uint64_t n_bytes) {
+            while(n_bytes > 0u) {
+                auto written = ::write(fd, buf, n_bytes);
+                if(written < 0) { throw std::runtime_error("Cannot write to the solution cache"); }
+                buf += written;
+                n_bytes -= static_cast<uint64_t>(written);
+            }
+        }
+
+        // Atomically replaces a file: readers which already mapped the old one keep reading it.
+        static void replace_file(const store_filenames& sf, const char* filename, const std::vector<char>& buf) {
+            auto fd = ::open(sf.tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(fd < 0) { throw std::runtime_error("Cannot create the solution cache"); }
+
+            try {
+                write_all(fd, buf.data(), buf.size());
+                if(::fsync(fd) != 0) { throw std::runtime_error("Cannot write to the solution cache"); }
+            } catch(...) {
+                ::close(fd);
+                std::remove(sf.tmp);
+                throw;
+            }
+
+            ::close(fd);
+
+            if(std::rename(sf.tmp, filename) != 0) { throw std::runtime_error("Cannot replace the solution cache"); }
+        }
+
+        static std::vector<char> serialise_entry(uint64_t key, const StableSetCollection& pool, const Graph& g) {
+            EntryHeader e{key, g.n_vertices, g.n_edges, g.n_partitions, 0u, 0u, 0u};
+            std::vector<uint32_t> sizes, ids;
+
+            for(const auto& colour : pool) {
+                if(colour.get_set().empty()) { continue; }
+                sizes.push_back(static_cast<uint32_t>(colour.get_set().size()));
+                ids.insert(ids.end(), colour.get_set().begin(), colour.get_set().end());
+            }
 
-                    return;
+            e.n_colours = static_cast<uint32_t>(sizes.size());
+            e.n_ids = static_cast<uint32_t>(ids.size());
+
+            std::vector<char> buf(entry_size(e), 0);
+            std::memcpy(buf.data() + sizeof(e), sizes.data(), sizes.size() * sizeof(uint32_t));
+            std::memcpy(buf.data() + sizeof(e) + sizes.size() * sizeof(uint32_t), ids.data(), ids.size() * sizeof(uint32_t));
+
+            e.checksum = entry_checksum(buf.data(), e);
+            std::memcpy(buf.data(), &e, sizeof(e));
+
+            return buf;
+        }
+
+        // Merges the journal into a new store, and then starts a new journal. Readers
+        // open the journal before the store, so whichever files they see, they never
+        // miss an entry. Must be called holding the lock.
+        static void compact(const store_filenames& sf, const MappedFile& s, const MappedFile& j) {
+            std::unordered_map<uint64_t, EntryRef> best;
+
+            if(auto h = read_header(s)) {
+                for(auto slot = 0u; slot < h->n_slots; ++slot) {
+                    auto sl = load<Slot>(s, slot_offset(slot));
+                    if(sl.key == 0u) { continue; }
+                    if(auto e = read_entry_header(s, sl.offset)) { best.emplace(sl.key, *e); }
                 }
             }
+
+            for_each_journal_entry(j, [&] (const EntryRef& e) {
+                auto it = best.find(e.header.key);
+
+                if(it == best.end()) {
+                    best.emplace(e.header.key, e);
+                } else if(it->second.header.n_vertices != e.header.n_vertices || it->second.header.n_edges != e.header.n_edges ||
+                          it->second.header.n_partitions != e.header.n_partitions || e.header.n_colours < it->second.header.n_colours) {
+                    // In the (unlikely) case of a key collision, the newest instance keeps the slot.
+                    it->second = e;
+                }
+            });
+
+            // Keep the table at most half full, so that probe sequences stay short.
+            auto n_slots = initial_slots;
+            while(n_slots < 2u * best.size()) { n_slots *= 2u; }
+
+            auto data_offset = sizeof(Header) + n_slots * sizeof(Slot);
+            std::vector<Slot> slots(n_slots, Slot{0u, 0u});
+            std::vector<char> buf(data_offset, 0);
+
+            for(const auto& kv : best) {
+                const auto& e = kv.second;
+                auto slot = kv.first & (n_slots - 1u);
+                while(slots[slot].key != 0u) { slot = (slot + 1u) & (n_slots - 1u); }
+
+                slots[slot] = Slot{kv.first, buf.size()};
+                buf.insert(buf.end(), e.file->data() + e.offset, e.file->data() + e.offset + entry_size(e.header));
+            }
+
+            Header h{{}, n_slots, best.size(), 0u};
+            std::memcpy(h.magic, store_magic, sizeof(store_magic));
+            std::memcpy(buf.data(), &h, sizeof(h));
+            std::memcpy(buf.data() + sizeof(Header), slots.data(), n_slots * sizeof(Slot));
+
+            replace_file(sf, sf.store, buf);
+            replace_file(sf, sf.journal, std::vector<char>(std::begin(journal_magic), std::end(journal_magic)));
+        }
+
+        void update_pool(const store_filenames& sf, ColumnPool& pool, const Graph& g) {
+            // No lock: the journal only grows, and the store is only ever replaced as a whole.
+            MappedFile j{sf.journal};
+            MappedFile s{sf.store};
+
+            auto e = find_best_entry(s, j, g, instance_key(g));
+            if(!e) { return; }
+
+            const auto* sizes = e->file->data() + e->offset + sizeof(EntryHeader);
+            const auto* ids = sizes + e->header.n_colours * sizeof(uint32_t);
+
+            for(auto c = 0u; c < e->header.n_colours; ++c) {
+                uint32_t size;
+                std::memcpy(&size, sizes + c * sizeof(uint32_t), sizeof(size));
+                assert(size > 0u);
+
+                std::vector<uint32_t> colour(size);
+                std::memcpy(colour.data(), ids, size * sizeof(uint32_t));
+                ids += size * sizeof(uint32_t);
+
+                pool.insert(StableSet{g, colour});
+            }
         }
 
         void bks_update_pool(ColumnPool& pool, const Graph& g) {
-            update_pool(bks_cf, pool, g);
+            update_pool(bks_sf, pool, g);
         }
 
         void init_update_pool(ColumnPool& pool, const Graph& g) {
-            update_pool(init_cf, pool, g);
+            update_pool(init_sf, pool, g);
         }
 
-        std::stringstream pool_to_ss(const ColumnPool& pool, const Graph& g) {
-            std::stringstream ss;
-            ss << g.data_filename << ";";
+        UpdateResult update_cache(const store_filenames& sf, const StableSetCollection& pool, const Graph& g) {
+            // The cache only saves work for later runs: failing to update it must not stop this one.
+            try {
+                auto key = instance_key(g);
+                CacheLock lock{sf.lock};
 
-            for(auto cid = 0u; cid < pool.size(); ++cid) {
-                const auto& s = pool[cid].get_set();
-                std::vector<uint32_t> colour(s.begin(), s.end());
+                auto j = MappedFile{sf.journal};
+                auto s = MappedFile{sf.store};
 
-                for(auto vid = 0u; vid < colour.size(); ++vid) {
-                    ss << colour[vid];
-                    if(vid < colour.size() - 1) { ss << ","; }
+                if(auto e = find_best_entry(s, j, g, key)) {
+                    if(e->header.n_colours <= pool.size()) { return UpdateResult::KeptExisting; }
                 }
 
-                if(cid < pool.size() - 1) { ss << ";"; }
-            }
+                // A writer which died mid-append leaves an incomplete entry at the end of the
+                // journal, which would hide anything appended after it: start a new journal.
+                if(!is_journal(j) || for_each_journal_entry(j, [] (const EntryRef&) {}) != j.size()) {
+                    compact(sf, s, j);
+                }
 
-            return ss;
-        }
+                auto buf = serialise_entry(key, pool, g);
+                auto fd = ::open(sf.journal, O_WRONLY | O_APPEND);
+                if(fd < 0) { throw std::runtime_error("Cannot open the solution cache journal"); }
 
-        void update_cache(const csv_filenames &cf, const ColumnPool &pool, const Graph &g) {
-            if(!index_exists(cf)) {
-                create_index(cf);
+                struct stat st;
+                auto journal_size = (::fstat(fd, &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0u;
+
+                try {
+                    write_all(fd, buf.data(), buf.size());
+                } catch(...) {
+                    ::close(fd);
+                    throw;
+                }
+
+                ::close(fd);
+
+                if(journal_size + buf.size() > journal_max_size) {
+                    j = MappedFile{sf.journal};
+                    s = MappedFile{sf.store};
+                    compact(sf, s, j);
+                }
+
+                return UpdateResult::Stored;
+            } catch(const std::exception& e) {
+                std::cerr << "Warning: " << e.what() << " (" << sf.store << ")" << std::endl;
+                return UpdateResult::Failed;
             }
+        }
 
-            std::ifstream idxin{cf.index};
-            std::ofstream idxout{cf.tmp};
+        void bks_update_cache(const StableSetCollection& pool, const Graph& g) {
+            update_cache(bks_sf, pool, g);
+        }
+
+        void init_update_cache(const StableSetCollection& pool, const Graph& g) {
+            update_cache(init_sf, pool, g);
+        }
 
+        // Colours of the instance in a text cache, if it has an entry for it. Each line of the
+        // text caches was an entry: the instance file name, and then the colours as comma-separated
+        // vertex ids, all separated by semicolons. Entries were matched by file name only.
+        static boost::optional<std::vector<std::vector<uint32_t>>> read_csv_entry(const char* csv_filename, const Graph& g) {
+            std::ifstream csv{csv_filename};
             std::string line;
-            bool updated = false;
-            while(std::getline(idxin, line)) {
-                if(!updated) {
-                    auto tokens = string_utils::split(line, ';');
 
-                    if(tokens.empty()) { continue; }
+            while(std::getline(csv, line)) {
+                auto tokens = string_utils::split(line, ';');
+                if(tokens.size() < 2u) { continue; }
+                if(string_utils::split(tokens[0], '/').back() != string_utils::split(g.data_filename, '/').back()) { continue; }
 
-                    if(is_same_file(tokens[0], g.data_filename)) {
-                        assert(tokens.size() > 1u);
+                std::vector<std::vector<uint32_t>> colours;
 
-                        if(tokens.size() - 1u > pool.size()) {
-                            auto ss = pool_to_ss(pool, g);
-                            idxout << ss.str() << "\n";
-                        } else {
-                            idxout << line << "\n";
-                        }
+                for(auto i = 1u; i < tokens.size(); ++i) {
+                    std::vector<uint32_t> colour;
 
-                        updated = true;
-                        continue;
+                    for(const auto& vstr : string_utils::split(tokens[i], ',')) {
+                        std::stringstream ss{vstr};
+                        uint32_t v = 0u;
+                        if(ss >> v) { colour.push_back(v); }
                     }
+
+                    if(!colour.empty()) { colours.push_back(colour); }
                 }
 
-                idxout << line << "\n";
+                return colours;
             }
 
-            if(!updated) {
-                auto ss = pool_to_ss(pool, g);
-                idxout << ss.str() << "\n";
-            }
+            return boost::none;
+        }
+
+        // Tells whether the colours are stable sets of g which, together, intersect all its partitions.
+        static bool is_valid_colouring(const std::vector<std::vector<uint32_t>>& colours, const Graph& g) {
+            std::vector<bool> covered(g.n_partitions, false);
 
-            idxin.close();
-            idxout.close();
+            for(const auto& colour : colours) {
+                for(auto i = 0u; i < colour.size(); ++i) {
+                    if(colour[i] >= g.n_vertices) { return false; }
+
+                    for(auto j = i + 1u; j < colour.size(); ++j) {
+                        if(colour[j] >= g.n_vertices || colour[i] == colour[j] || g.connected(colour[i], colour[j])) { return false; }
+                    }
+
+                    covered[g.partition_for(colour[i])] = true;
+                }
+            }
 
-            std::remove(cf.bak);
-            std::rename(cf.index, cf.bak);
-            std::remove(cf.index);
-            std::rename(cf.tmp, cf.index);
-            std::remove(cf.tmp);
+            return std::find(covered.begin(), covered.end(), false) == covered.end();
         }
 
-        void bks_update_cache(const ColumnPool &pool, const Graph &g) {
-            update_cache(bks_cf, pool, g);
+        static void import_csv_cache(const char* csv_filename, const store_filenames& sf, const Graph& g) {
+            auto colours = read_csv_entry(csv_filename, g);
+
+            if(!colours) {
+                std::cout << "No entry for " << g.data_filename << " in " << csv_filename << std::endl;
+                return;
+            }
+
+            // Ids refer to the preprocessed graph, and the preprocessing may have changed since the entry was written.
+            if(!is_valid_colouring(*colours, g)) {
+                std::cerr << "Warning: the entry for " << g.data_filename << " in " << csv_filename << " is not a valid colouring, skipped" << std::endl;
+                return;
+            }
+
+            StableSetCollection pool;
+            for(const auto& colour : *colours) { pool.emplace_back(g, colour); }
+
+            switch(update_cache(sf, pool, g)) {
+                case UpdateResult::Stored:
+                    std::cout << "Imported " << pool.size() << " colours from " << csv_filename << " into " << sf.store << std::endl;
+                    break;
+                case UpdateResult::KeptExisting:
+                    std::cout << sf.store << " already has a solution with at most " << pool.size() << " colours: kept the existing entry" << std::endl;
+                    break;
+                case UpdateResult::Failed:
+                    std::cerr << "Warning: could not import the entry of " << csv_filename << " into " << sf.store << std::endl;
+                    break;
+            }
         }
 
-        void init_update_cache(const ColumnPool &pool, const Graph &g) {
-            update_cache(init_cf, pool, g);
+        void import_csv_caches(const Graph& g) {
+            import_csv_cache("bks.csv", bks_sf, g);
+            import_csv_cache("init.csv", init_sf, g);
         }
     }
-}
\ No newline at end of file
+}
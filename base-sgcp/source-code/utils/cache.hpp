@@ -1,33 +1,49 @@
 #ifndef _BKS_HPP
 #define _BKS_HPP
 
-#include <sstream>
 #include "../graph.hpp"
 #include "../branch-and-price/column_pool.hpp"
 
+#include <cstdint>
+
 namespace sgcp {
     namespace cache {
-        struct csv_filenames {
-            const char* index;
+        // Binary stores of known solutions, shared by concurrent processes.
+        // The store file holds one entry per instance, indexed by an open-addressing
+        // hash table (instance key -> entry offset); it is never modified in place.
+        // New solutions are appended to the journal, under an exclusive lock on the
+        // lock file, and the journal is merged into a new store when it grows too
+        // large. Readers take no lock.
+        struct store_filenames {
+            const char* store;
+            const char* journal;
+            const char* lock;
             const char* tmp;
-            const char* bak;
         };
 
-        bool is_same_file(const std::string s1, const std::string s2);
-
-        bool index_exists(const csv_filenames& cf);
-        void create_index(const csv_filenames& cf);
+        // Hash of the preprocessed instance: its vertices, edges and partitions.
+        // Two files describing the same instance share the key, and vice versa
+        // editing an instance file changes its key.
+        uint64_t instance_key(const Graph& g);
 
-        void update_pool(const csv_filenames& cf, ColumnPool& pool, const Graph& g);
+        void update_pool(const store_filenames& sf, ColumnPool& pool, const Graph& g);
         void bks_update_pool(ColumnPool& pool, const Graph& g);
         void init_update_pool(ColumnPool& pool, const Graph& g);
 
-        void update_cache(const csv_filenames &cf, const ColumnPool &pool, const Graph &g);
-        void bks_update_cache(const ColumnPool &pool, const Graph &g);
-        void init_update_cache(const ColumnPool &pool, const Graph &g);
+        enum class UpdateResult { Stored, KeptExisting, Failed };
+
+        // Stores the solution, unless the store already has one with at most as many colours.
+        // A failure is reported on std::cerr, and does not throw.
+        UpdateResult update_cache(const store_filenames& sf, const StableSetCollection& pool, const Graph& g);
+        void bks_update_cache(const StableSetCollection& pool, const Graph& g);
+        void init_update_cache(const StableSetCollection& pool, const Graph& g);
 
-        std::stringstream pool_to_ss(const ColumnPool& pool, const Graph& g);
+        // Copies the solutions of the instance from the text caches which came before the
+        // binary stores (bks.csv and init.csv, in the working directory) into the stores.
+        // Entries which are not a valid colouring of the instance, as it is preprocessed now,
+        // are skipped with a warning.
+        void import_csv_caches(const Graph& g);
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,51 @@
+#include "mapped_file.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <utility>
+
+namespace sgcp {
+    MappedFile::MappedFile(const std::string& filename) : first{nullptr}, length{0u} {
+        auto fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0) { return; }
+
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto* addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+            if(addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map file: " + filename);
+            }
+
+            first = static_cast<const char*>(addr);
+            length = static_cast<std::size_t>(st.st_size);
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept : first{other.first}, length{other.length} {
+        other.first = nullptr;
+        other.length = 0u;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if(this != &other) {
+            unmap();
+            first = std::exchange(other.first, nullptr);
+            length = std::exchange(other.length, 0u);
+        }
+        return *this;
+    }
+
+    void MappedFile::unmap() {
+        if(first != nullptr) { ::munmap(const_cast<char*>(first), length); }
+        first = nullptr;
+        length = 0u;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef _MAPPED_FILE_HPP
+#define _MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace sgcp {
+    // Read-only memory mapping of a whole file. A file which does not exist,
+    // or is empty, gives an empty mapping (data() is null and size() is 0).
+    class MappedFile {
+        const char* first;
+        std::size_t length;
+
+        void unmap();
+
+    public:
+        MappedFile() : first{nullptr}, length{0u} {}
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile() { unmap(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const char* data() const { return first; }
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0u; }
+    };
+}
+
+#endif
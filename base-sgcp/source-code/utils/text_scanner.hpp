@@ -0,0 +1,57 @@
+#ifndef _TEXT_SCANNER_HPP
+#define _TEXT_SCANNER_HPP
+
+#include <boost/optional.hpp>
+
+#include <charconv>
+#include <cstdint>
+
+namespace sgcp {
+    // Reads unsigned integers out of a text buffer (typically a memory-mapped
+    // file), without copying it. Integers can either be read regardless of line
+    // breaks, or one line at a time.
+    class TextScanner {
+        const char* pos;
+        const char* last;
+
+        static bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+        boost::optional<uint32_t> parse_uint() {
+            uint32_t value;
+            auto result = std::from_chars(pos, last, value);
+            if(result.ec != std::errc{}) { return boost::none; }
+            pos = result.ptr;
+            return value;
+        }
+
+    public:
+        TextScanner(const char* first, const char* last) : pos{first}, last{last} {}
+
+        bool at_end() const { return pos == last; }
+
+        // Skips blanks and line breaks.
+        void skip_whitespace() {
+            while(pos != last && (is_blank(*pos) || *pos == '\n')) { ++pos; }
+        }
+
+        // Reads the next integer, skipping any blanks and line breaks before it.
+        boost::optional<uint32_t> next_uint() {
+            skip_whitespace();
+            return parse_uint();
+        }
+
+        // Reads the next integer on the current line, if there is one.
+        boost::optional<uint32_t> next_uint_in_line() {
+            while(pos != last && is_blank(*pos)) { ++pos; }
+            return parse_uint();
+        }
+
+        // Moves to the beginning of the next line.
+        void next_line() {
+            while(pos != last && *pos != '\n') { ++pos; }
+            if(pos != last) { ++pos; }
+        }
+    };
+}
+
+#endif
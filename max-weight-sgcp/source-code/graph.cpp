@@ -3,29 +3,61 @@
 //
 
 #include "graph.h"
+#include "instance_reader.h"
 
+#include <algorithm>
 #include <cstdlib>
-#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 #include <as/and_die.h>
-#include <as/repeat.h>
 #include <as/graph.h>
 #include <as/containers.h>
 
 namespace sgcp_cliques {
     namespace {
-        // Turns each cluster into a clique.
-        void add_partition_cliques(ClusteredGraph& graph) {
-            for(auto v = 0u; v < boost::num_vertices(graph); ++v) {
-                for(auto w = v + 1; w < boost::num_vertices(graph); ++w) {
-                    if(graph[v] == graph[w]) {
-                        if(!boost::edge(v, w, graph).second) {
-                            boost::add_edge(v, w, graph);
-                        }
+        // Returns the edges which turn each cluster into a clique and are not in the
+        // graph yet, given the cluster of each vertex and the edges already present.
+        std::vector<std::pair<std::size_t, std::size_t>> partition_clique_edges(
+            const std::vector<std::size_t>& cluster_of,
+            const std::vector<std::pair<std::size_t, std::size_t>>& edges
+        ) {
+            const auto n = cluster_of.size();
+
+            if(n == 0u) {
+                return {};
+            }
+
+            std::vector<std::vector<std::size_t>> neighbours(n);
+            std::vector<std::vector<std::size_t>> members(*std::max_element(cluster_of.begin(), cluster_of.end()) + 1u);
+            std::vector<std::size_t> position(n);
+
+            for(const auto& [source, target] : edges) {
+                neighbours[source].push_back(target);
+                neighbours[target].push_back(source);
+            }
+
+            for(auto v = 0u; v < n; ++v) {
+                position[v] = members[cluster_of[v]].size();
+                members[cluster_of[v]].push_back(v);
+            }
+
+            // Marks the neighbours of the current vertex v with v itself.
+            std::vector<std::size_t> mark(n, n);
+            std::vector<std::pair<std::size_t, std::size_t>> clique_edges;
+
+            for(auto v = 0u; v < n; ++v) {
+                for(const auto w : neighbours[v]) { mark[w] = v; }
+
+                const auto& cluster = members[cluster_of[v]];
+
+                for(auto i = position[v] + 1u; i < cluster.size(); ++i) {
+                    if(mark[cluster[i]] != v) {
+                        clique_edges.emplace_back(v, cluster[i]);
                     }
                 }
             }
+
+            return clique_edges;
         }
 
         // Check if a pair of arcs corresponding to the edges {v1, v2}, {w1, w2} is simplicial.
@@ -60,64 +92,34 @@ namespace sgcp_cliques {
     ClusteredGraph read_clustered_graph(std::string graph_file) {
         using as::and_die;
 
-        std::ifstream ifs(graph_file);
-
-        if(ifs.fail()) {
-            std::cerr << "Cannot read file " << graph_file << and_die();
-            std::exit(1);
-        }
-
-        std::size_t num_vertices, num_edges, num_clusters;
-
-        if(!(ifs >> num_vertices)) {
-            std::cerr << "Cannot read number of vertices from " << graph_file << and_die();
-        }
+        Instance instance;
 
-        if(!(ifs >> num_edges)) {
-            std::cerr << "Cannot read number of edges from " << graph_file << and_die();
+        try {
+            instance = read_instance(graph_file, false);
+        } catch(const std::runtime_error& e) {
+            std::cerr << e.what() << and_die();
         }
 
-        if(!(ifs >> num_clusters)) {
-            std::cerr << "Cannot read number of partitions from " << graph_file << and_die();
-        }
-
-        ClusteredGraph graph;
-        std::vector<std::vector<std::size_t>> clusters(num_clusters);
-
-        as::repeat(num_vertices, [&] () { boost::add_vertex(graph); });
-
-        as::repeat(num_edges, [&] () {
-            std::size_t source, target;
+        // Vertices in no cluster are treated as if they were in cluster 0.
+        std::vector<std::size_t> cluster_of(instance.num_vertices, 0u);
 
-            if(!(ifs >> source >> target)) {
-                std::cerr << "Cannot read an edge from " << graph_file << and_die();
+        for(auto cluster = 0u; cluster < instance.clusters.size(); ++cluster) {
+            for(const auto vertex : instance.clusters[cluster]) {
+                cluster_of[vertex] = cluster;
             }
+        }
 
-            boost::add_edge(source, target, graph);
-        });
-
-        std::stringstream ss;
-        std::string line;
-
-        ifs >> std::ws;
-
-        for(auto cluster = 0u; cluster < num_clusters; ++cluster) {
-            std::getline(ifs, line);
-            ss.str(line);
-
-            std::size_t vertex;
+        auto edges = instance.edges;
+        const auto clique_edges = partition_clique_edges(cluster_of, edges);
+        edges.insert(edges.end(), clique_edges.begin(), clique_edges.end());
 
-            while(ss >> vertex) {
-                graph[vertex] = cluster;
-                clusters[cluster].push_back(vertex);
-            }
+        auto graph = build_graph<ClusteredGraph>(instance.num_vertices, edges);
 
-            ss.str("");
-            ss.clear();
+        for(auto v = 0u; v < instance.num_vertices; ++v) {
+            graph[v] = cluster_of[v];
         }
 
-        graph[boost::graph_bundle] = { num_clusters, clusters };
-        add_partition_cliques(graph);
+        graph[boost::graph_bundle] = { instance.clusters.size(), instance.clusters };
 
         return graph;
     }
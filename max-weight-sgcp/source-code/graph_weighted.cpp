@@ -3,8 +3,10 @@
 //
 
 #include "graph_weighted.h"
-#include <fstream>
-#include <as/repeat.h>
+#include "instance_reader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
 #include <as/graph.h>
 
 #ifndef IL_STD
@@ -14,17 +16,47 @@
 
 namespace smwgcp_cliques {
     namespace {
-        void add_partition_cliques(ClusteredWeightedGraph& graph) {
-            for(const auto& cluster : graph[boost::graph_bundle].clusters) {
+        // Returns the edges which turn each cluster into a clique and are not in the graph yet.
+        // Edges are listed cluster by cluster, in the order of the vertices within the clusters.
+        std::vector<std::pair<std::size_t, std::size_t>> partition_clique_edges(
+            std::size_t num_vertices,
+            const std::vector<std::vector<std::size_t>>& clusters,
+            const std::vector<std::pair<std::size_t, std::size_t>>& edges
+        ) {
+            std::vector<std::vector<std::size_t>> neighbours(num_vertices);
+
+            for(const auto& [source, target] : edges) {
+                neighbours[source].push_back(target);
+                neighbours[target].push_back(source);
+            }
+
+            // Marks the neighbours of the vertex currently being linked with
+            // the rest of its cluster. Each vertex of each cluster gets a new mark.
+            std::vector<std::size_t> mark(num_vertices, 0u);
+            std::size_t current_mark = 0u;
+            std::vector<std::pair<std::size_t, std::size_t>> clique_edges;
+
+            for(const auto& cluster : clusters) {
                 for(auto i = 0u; i < cluster.size(); ++i) {
+                    const auto vi = cluster[i];
+
+                    ++current_mark;
+                    for(const auto w : neighbours[vi]) { mark[w] = current_mark; }
+
                     for(auto j = i + 1; j < cluster.size(); ++j) {
-                        auto vi = cluster[i], vj = cluster[j];
-                        if(!boost::edge(vi, vj, graph).second) {
-                            boost::add_edge(vi, vj, graph);
+                        const auto vj = cluster[j];
+
+                        if(mark[vj] != current_mark) {
+                            clique_edges.emplace_back(vi, vj);
+                            neighbours[vi].push_back(vj);
+                            neighbours[vj].push_back(vi);
+                            mark[vj] = current_mark;
                         }
                     }
                 }
             }
+
+            return clique_edges;
         }
 
         // True iff the first vertex has larger weight than the second vertex.
@@ -74,85 +106,29 @@ namespace smwgcp_cliques {
     }
 
     ClusteredWeightedGraph read_clustered_weighted_graph(std::string graph_file) {
-        std::ifstream ifs(graph_file);
-
-        if(ifs.fail()) {
-            std::fprintf(stderr, "Cannot read graph file!\n");
-            std::exit(1);
-        }
-
-        std::size_t num_vertices, num_edges, num_clusters;
-
-        if(!(ifs >> num_vertices)) {
-            std::fprintf(stderr, "Cannot read the number of vertices.\n");
-            std::exit(1);
-        }
-
-        if(!(ifs >> num_edges)) {
-            std::fprintf(stderr, "Cannot read the number of edges.\n");
-            std::exit(1);
-        }
+        sgcp_cliques::Instance instance;
 
-        if(!(ifs >> num_clusters)) {
-            std::fprintf(stderr, "Cannot read the number of clusters.\n");
+        try {
+            instance = sgcp_cliques::read_instance(graph_file, true);
+        } catch(const std::runtime_error& e) {
+            std::fprintf(stderr, "%s\n", e.what());
             std::exit(1);
         }
 
-        ClusteredWeightedGraph graph;
-
-        as::repeat(num_vertices, [&] () {
-            boost::add_vertex(ClusteredVertexProperties(), graph);
-        });
-
-        std::vector<float> cluster_weights;
-
-        as::repeat(num_clusters, [&] {
-            float weight;
-
-            if(!(ifs >> weight)) {
-                std::fprintf(stderr, "Cannot read a vertex weight.\n");
-                std::exit(1);
-            }
-
-            cluster_weights.push_back(weight);
-        });
-
-        as::repeat(num_edges, [&] () {
-            std::size_t source, target;
+        auto edges = instance.edges;
+        const auto clique_edges = partition_clique_edges(instance.num_vertices, instance.clusters, edges);
+        edges.insert(edges.end(), clique_edges.begin(), clique_edges.end());
 
-            if(!(ifs >> source >> target)) {
-                std::fprintf(stderr, "Cannot read an edge.\n");
-                std::exit(1);
-            }
-
-            boost::add_edge(source, target, graph);
-        });
-
-        std::stringstream ss;
-        std::string line;
-
-        ifs >> std::ws;
+        auto graph = sgcp_cliques::build_graph<ClusteredWeightedGraph>(instance.num_vertices, edges);
 
-        std::vector<std::vector<std::size_t>> clusters(num_clusters);
-
-        for(auto cluster = 0u; cluster < num_clusters; ++cluster) {
-            std::getline(ifs, line);
-            ss.str(line);
-
-            std::size_t vertex;
-
-            while(ss >> vertex) {
+        for(auto cluster = 0u; cluster < instance.clusters.size(); ++cluster) {
+            for(const auto vertex : instance.clusters[cluster]) {
                 graph[vertex].cluster = cluster;
-                graph[vertex].weight = cluster_weights[cluster];
-                clusters[cluster].push_back(vertex);
+                graph[vertex].weight = instance.cluster_weights[cluster];
             }
-
-            ss.str("");
-            ss.clear();
         }
 
-        graph[boost::graph_bundle] = { num_clusters, clusters, cluster_weights };
-        add_partition_cliques(graph);
+        graph[boost::graph_bundle] = { instance.clusters.size(), instance.clusters, instance.cluster_weights };
 
         return graph;
     }
@@ -0,0 +1,198 @@
+#include "instance_reader.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace sgcp_cliques {
+    namespace {
+        // Read-only memory map of a whole file.
+        class MappedFile {
+            const char* first = nullptr;
+            std::size_t length = 0u;
+
+        public:
+            explicit MappedFile(const std::string& file) {
+                const auto fd = ::open(file.c_str(), O_RDONLY);
+
+                if(fd < 0) {
+                    throw std::runtime_error("Cannot read file " + file);
+                }
+
+                struct stat st;
+
+                if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+                    const auto addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+                    if(addr != MAP_FAILED) {
+                        first = static_cast<const char*>(addr);
+                        length = static_cast<std::size_t>(st.st_size);
+                    }
+                }
+
+                ::close(fd);
+
+                if(first == nullptr) {
+                    throw std::runtime_error("Cannot read file " + file);
+                }
+            }
+
+            ~MappedFile() { ::munmap(const_cast<char*>(first), length); }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const char* begin() const { return first; }
+            const char* end() const { return first + length; }
+        };
+
+        // Parses numbers straight out of the mapped file.
+        class Scanner {
+            const char* pos;
+            const char* last;
+
+            // Longest token accepted as a floating-point number.
+            static constexpr std::size_t max_float_length = 64u;
+
+            static bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+            template<typename T>
+            std::optional<T> parse() {
+                T value;
+                const auto [ptr, ec] = std::from_chars(pos, last, value);
+
+                if(ec != std::errc{}) {
+                    return std::nullopt;
+                }
+
+                pos = ptr;
+                return value;
+            }
+
+        public:
+            Scanner(const char* first, const char* last) : pos{first}, last{last} {}
+
+            // Skips blanks and line breaks.
+            void skip_whitespace() {
+                while(pos != last && (is_blank(*pos) || *pos == '\n')) { ++pos; }
+            }
+
+            // Reads the next number, skipping any blanks and line breaks before it.
+            template<typename T>
+            std::optional<T> next() {
+                skip_whitespace();
+                return parse<T>();
+            }
+
+            // Reads the next floating-point number, skipping any blanks and line breaks before it.
+            // std::from_chars has no floating-point overloads before GCC 11, so the token is
+            // copied out of the mapped file (which is not null-terminated) and parsed by strtof.
+            std::optional<float> next_float() {
+                skip_whitespace();
+
+                const auto token_end = std::find_if(pos, last, [] (char c) { return is_blank(c) || c == '\n'; });
+                const auto token = std::string{pos, token_end};
+
+                if(token.empty() || token.size() > max_float_length) {
+                    return std::nullopt;
+                }
+
+                char* parsed_end = nullptr;
+                const auto value = std::strtof(token.c_str(), &parsed_end);
+
+                if(parsed_end != token.c_str() + token.size()) {
+                    return std::nullopt;
+                }
+
+                pos = token_end;
+                return value;
+            }
+
+            // Reads the next number on the current line, if there is one.
+            template<typename T>
+            std::optional<T> next_in_line() {
+                while(pos != last && is_blank(*pos)) { ++pos; }
+                return parse<T>();
+            }
+
+            // Moves to the beginning of the next line.
+            void next_line() {
+                while(pos != last && *pos != '\n') { ++pos; }
+                if(pos != last) { ++pos; }
+            }
+        };
+    }
+
+    Instance read_instance(const std::string& graph_file, bool weighted) {
+        const MappedFile file{graph_file};
+        Scanner scanner{file.begin(), file.end()};
+
+        const auto read = [&] (const std::string& what) -> std::size_t {
+            const auto n = scanner.next<std::size_t>();
+
+            if(!n) {
+                throw std::runtime_error("Cannot read " + what + " from " + graph_file);
+            }
+
+            return *n;
+        };
+
+        Instance instance;
+
+        instance.num_vertices = read("number of vertices");
+        const auto num_edges = read("number of edges");
+        const auto num_clusters = read("number of partitions");
+
+        if(weighted) {
+            instance.cluster_weights.reserve(num_clusters);
+
+            for(auto cluster = 0u; cluster < num_clusters; ++cluster) {
+                const auto weight = scanner.next_float();
+
+                if(!weight) {
+                    throw std::runtime_error("Cannot read a cluster weight from " + graph_file);
+                }
+
+                instance.cluster_weights.push_back(*weight);
+            }
+        }
+
+        instance.edges.reserve(num_edges);
+
+        for(auto edge = 0u; edge < num_edges; ++edge) {
+            const auto source = read("an edge");
+            const auto target = read("an edge");
+
+            if(source >= instance.num_vertices || target >= instance.num_vertices) {
+                throw std::runtime_error("Invalid edge in " + graph_file);
+            }
+
+            instance.edges.emplace_back(source, target);
+        }
+
+        scanner.skip_whitespace();
+
+        instance.clusters.resize(num_clusters);
+
+        for(auto& cluster : instance.clusters) {
+            while(const auto vertex = scanner.next_in_line<std::size_t>()) {
+                if(*vertex >= instance.num_vertices) {
+                    throw std::runtime_error("Invalid vertex in a cluster of " + graph_file);
+                }
+
+                cluster.push_back(*vertex);
+            }
+
+            scanner.next_line();
+        }
+
+        return instance;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef SGCP_CLIQUES_INSTANCE_READER_H
+#define SGCP_CLIQUES_INSTANCE_READER_H
+
+#include <boost/graph/adjacency_list.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sgcp_cliques {
+    // Contents of an instance file, before any graph is built from it.
+    struct Instance {
+        std::size_t num_vertices;
+
+        // Edges, in the order they appear in the file.
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+
+        // Clusters, in the order they appear in the file.
+        std::vector<std::vector<std::size_t>> clusters;
+
+        // Weights of the clusters (only for weighted instances).
+        std::vector<float> cluster_weights;
+    };
+
+    // Reads an instance file, through a memory map. The format is the one described
+    // in read_clustered_graph; if weighted is true, the cluster weights come right
+    // after the number of clusters, as described in read_clustered_weighted_graph.
+    // Throws std::runtime_error if the file cannot be read.
+    Instance read_instance(const std::string& graph_file, bool weighted);
+
+    // Builds a graph with the given edges, added in order. Each out-edge list is
+    // sized once, from the vertex degrees, instead of growing edge by edge.
+    template<typename Graph>
+    Graph build_graph(std::size_t num_vertices, const std::vector<std::pair<std::size_t, std::size_t>>& edges) {
+        std::vector<std::size_t> degree(num_vertices, 0u);
+
+        for(const auto& [source, target] : edges) {
+            ++degree[source];
+            ++degree[target];
+        }
+
+        Graph graph(num_vertices);
+
+        for(auto v = 0u; v < num_vertices; ++v) {
+            graph.out_edge_list(v).reserve(degree[v]);
+        }
+
+        for(const auto& [source, target] : edges) {
+            boost::add_edge(source, target, graph);
+        }
+
+        return graph;
+    }
+}
+
+#endif //SGCP_CLIQUES_INSTANCE_READER_H